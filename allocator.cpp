@@ -0,0 +1,64 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Monday, 19 October 2026 08:15:52 AM
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "allocator.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+namespace tycho
+{
+namespace input
+{
+
+	namespace detail
+	{
+		/// allocator using global new and delete
+		class heap_allocator : public allocator
+		{
+		public:
+			virtual void* allocate(size_t size) { return ::operator new(size); }
+			virtual void deallocate(void* p, size_t) { ::operator delete(p); }
+		};
+
+		/// alignment of every block handed out by an arena, enough for any fundamental type
+		const size_t ArenaAlignment = 16;
+	}
+
+	/// \returns allocator using global new and delete
+	allocator& allocator::get_heap()
+	{
+		static detail::heap_allocator heap;
+		return heap;
+	}
+
+	/// constructor
+	arena_allocator::arena_allocator(void* buffer, size_t size) :
+		m_buffer((char*)buffer),
+		m_size(size),
+		m_used(0)
+	{
+		TYCHO_ASSERT(((size_t)buffer & (detail::ArenaAlignment - 1)) == 0);
+	}
+
+	/// \returns the next block in the arena, asserts and returns 0 if it is exhausted
+	void* arena_allocator::allocate(size_t size)
+	{
+		size_t start = (m_used + detail::ArenaAlignment - 1) & ~(detail::ArenaAlignment - 1);
+		if(start + size > m_size)
+		{
+			TYCHO_ASSERT(!"input arena exhausted");
+			return 0;
+		}
+		m_used = start + size;
+		return m_buffer + start;
+	}
+
+} // end namespace
+} // end namespace
@@ -0,0 +1,97 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Monday, 19 October 2026 08:15:52 AM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __ALLOCATOR_H_2F8A6C13_94D7_4E0B_B5C1_7A3E09D2F684_
+#define __ALLOCATOR_H_2F8A6C13_94D7_4E0B_B5C1_7A3E09D2F684_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+#include <stddef.h>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+
+	/// source of the objects the interface creates for drivers, devices, binding
+	/// sets and batched handlers. Games can route these into their own pools or
+	/// arenas, the default is the heap.
+	class TYCHO_INPUT_ABI allocator
+	{
+	public:
+		/// destructor
+		virtual ~allocator() {}
+
+		/// \returns a block of at least size bytes aligned for any fundamental type
+		virtual void* allocate(size_t size) = 0;
+
+		/// free a block returned by allocate
+		virtual void deallocate(void* p, size_t size) = 0;
+
+		/// \returns allocator using global new and delete
+		static allocator& get_heap();
+
+		/// construct an object in memory from this allocator
+		template<class T> T* create()
+		{
+			return new(allocate(sizeof(T))) T();
+		}
+
+		/// destroy an object made with create
+		template<class T> void destroy(T* p)
+		{
+			if(!p)
+				return;
+			p->~T();
+			deallocate(p, sizeof(T));
+		}
+	};
+
+	/// allocates linearly from a fixed block, freeing is a no-op and everything
+	/// goes at once when the arena is reset or destroyed.
+	class TYCHO_INPUT_ABI arena_allocator : public allocator
+	{
+	public:
+		/// constructor
+		/// \param buffer memory to allocate from, not owned.
+		/// \param size size of the buffer in bytes.
+		arena_allocator(void* buffer, size_t size);
+
+		/// \name allocator interface
+		//@{
+		virtual void* allocate(size_t size);
+		virtual void deallocate(void*, size_t) {}
+		//@}
+
+		/// release everything allocated so far, nothing allocated from it may still be in use
+		void reset() { m_used = 0; }
+
+		/// \returns the number of bytes allocated including alignment padding
+		size_t get_used() const { return m_used; }
+
+	private:
+		/// non copyable
+		arena_allocator(const arena_allocator&);
+		void operator=(const arena_allocator&);
+
+		char*	m_buffer;
+		size_t	m_size;
+		size_t	m_used;
+	};
+
+} // end namespace
+} // end namespace
+
+#endif // __ALLOCATOR_H_2F8A6C13_94D7_4E0B_B5C1_7A3E09D2F684_
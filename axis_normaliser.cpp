@@ -0,0 +1,252 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Sunday, 18 October 2026 03:12:48 PM
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "axis_normaliser.h"
+#include "input/intrinsics.h"
+#include <math.h>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+
+	namespace detail
+	{
+		/// states transposed per call, 2 sticks and 2 triggers each
+		static const int BatchStates = 32;
+		static const int BatchLanes = BatchStates * 2;
+		
+		static const float StickRange = 32768.0f;
+		static const float TriggerRange = 255.0f;
+		
+		/// structure of arrays view of a batch of states. Lanes past the end of 
+		/// the batch are zero so the vector path can always run whole registers.
+		struct axis_batch
+		{
+			float x[BatchLanes];		///< stick x, lane 2i is state i's left stick, 2i+1 its right
+			float y[BatchLanes];		///< stick y
+			float dz_x[BatchLanes];		///< x deadzone, also the radial deadzone
+			float dz_y[BatchLanes];		///< y deadzone
+			float t[BatchLanes];		///< trigger, lane 2i is state i's left trigger
+			float dz_t[BatchLanes];		///< trigger threshold
+		};
+
+		/// transpose count states into the batch
+		/// \returns number of lanes to process, rounded up to a multiple of 4
+		static int gather(const gamepad_state* states, int count, const gamepad_config& config, axis_batch& b)
+		{
+			const float dz_lx = (float)config.deadzones[gamepad_axis_lthumb_x];
+			const float dz_ly = (float)config.deadzones[gamepad_axis_lthumb_y];
+			const float dz_rx = (float)config.deadzones[gamepad_axis_rthumb_x];
+			const float dz_ry = (float)config.deadzones[gamepad_axis_rthumb_y];
+			const float dz_lt = (float)config.deadzones[gamepad_axis_ltrigger];
+			const float dz_rt = (float)config.deadzones[gamepad_axis_rtrigger];
+			for(int i = 0; i < count; ++i)
+			{
+				const core::int16* a = states[i].axes;
+				const int l = i * 2;
+				b.x[l] = a[gamepad_axis_lthumb_x];
+				b.y[l] = a[gamepad_axis_lthumb_y];
+				b.dz_x[l] = dz_lx;
+				b.dz_y[l] = dz_ly;
+				b.x[l+1] = a[gamepad_axis_rthumb_x];
+				b.y[l+1] = a[gamepad_axis_rthumb_y];
+				b.dz_x[l+1] = dz_rx;
+				b.dz_y[l+1] = dz_ry;
+				b.t[l] = a[gamepad_axis_ltrigger];
+				b.dz_t[l] = dz_lt;
+				b.t[l+1] = a[gamepad_axis_rtrigger];
+				b.dz_t[l+1] = dz_rt;
+			}
+			int lanes = count * 2;
+			int padded = (lanes + 3) & ~3;
+			for(int l = lanes; l < padded; ++l)
+			{
+				b.x[l] = b.y[l] = b.dz_x[l] = b.dz_y[l] = 0;
+				b.t[l] = b.dz_t[l] = 0;
+			}
+			return padded;
+		}
+		
+		/// write the normalised lanes back out per state, results overwrite the inputs
+		static void scatter(const axis_batch& b, int count, float* out)
+		{
+			for(int i = 0; i < count; ++i)
+			{
+				float* o = out + i * gamepad_axis_count;
+				const int l = i * 2;
+				o[gamepad_axis_lthumb_x] = b.x[l];
+				o[gamepad_axis_lthumb_y] = b.y[l];
+				o[gamepad_axis_rthumb_x] = b.x[l+1];
+				o[gamepad_axis_rthumb_y] = b.y[l+1];
+				o[gamepad_axis_ltrigger] = b.t[l];
+				o[gamepad_axis_rtrigger] = b.t[l+1];
+			}
+		}
+		
+		//////////////////////////////////////////////////////////////////////////
+		// scalar path. Every operation here has a matching single IEEE operation 
+		// in the vector path so the results agree to the bit, don't introduce
+		// reciprocals or anything the compiler could fuse.
+		//////////////////////////////////////////////////////////////////////////
+		
+		static inline float normalise_axial(float v, float dz)
+		{
+			float a = fabsf(v) - dz;
+			if(!(a > 0))
+				return 0;
+			return (v < 0 ? -a : a) / (StickRange - dz);
+		}
+		
+		static void normalise_lanes_scalar(axis_batch& b, int lanes, deadzone_mode mode)
+		{
+			for(int l = 0; l < lanes; ++l)
+			{
+				const float x = b.x[l];
+				const float y = b.y[l];
+				const float dz = b.dz_x[l];
+				if(mode == deadzone_axial)
+				{
+					b.x[l] = normalise_axial(x, dz);
+					b.y[l] = normalise_axial(y, b.dz_y[l]);
+				}
+				else
+				{
+					const float x2 = x * x;
+					const float y2 = y * y;
+					const float mag = sqrtf(x2 + y2);
+					if(!(mag > dz))
+					{
+						b.x[l] = b.y[l] = 0;
+					}
+					else if(mode == deadzone_radial)
+					{
+						b.x[l] = x / StickRange;
+						b.y[l] = y / StickRange;
+					}
+					else
+					{
+						float s = (mag - dz) / (StickRange - dz);
+						if(s > 1.0f)
+							s = 1.0f;
+						b.x[l] = (x / mag) * s;
+						b.y[l] = (y / mag) * s;
+					}
+				}
+				
+				const float t = b.t[l] - b.dz_t[l];
+				b.t[l] = t > 0 ? t / (TriggerRange - b.dz_t[l]) : 0;
+			}
+		}
+
+#if TYCHO_INPUT_SSE2
+		//////////////////////////////////////////////////////////////////////////
+		// SSE2 path, four lanes per iteration. Branches are replaced by masks, 
+		// masked out lanes are forced to +0 like the scalar path.
+		//////////////////////////////////////////////////////////////////////////
+		
+		static inline __m128 normalise_axial(__m128 v, __m128 dz, __m128 sign, __m128 range)
+		{
+			__m128 a = _mm_sub_ps(_mm_andnot_ps(sign, v), dz);
+			__m128 live = _mm_cmpgt_ps(a, _mm_setzero_ps());
+			__m128 r = _mm_div_ps(_mm_or_ps(a, _mm_and_ps(sign, v)), _mm_sub_ps(range, dz));
+			return _mm_and_ps(r, live);
+		}
+
+		static void normalise_lanes_sse(axis_batch& b, int lanes, deadzone_mode mode)
+		{
+			const __m128 sign = _mm_set1_ps(-0.0f);
+			const __m128 range = _mm_set1_ps(StickRange);
+			const __m128 trigger_range = _mm_set1_ps(TriggerRange);
+			const __m128 one = _mm_set1_ps(1.0f);
+			const __m128 zero = _mm_setzero_ps();
+			for(int l = 0; l < lanes; l += 4)
+			{
+				const __m128 x = _mm_loadu_ps(b.x + l);
+				const __m128 y = _mm_loadu_ps(b.y + l);
+				const __m128 dz = _mm_loadu_ps(b.dz_x + l);
+				__m128 ox, oy;
+				if(mode == deadzone_axial)
+				{
+					ox = normalise_axial(x, dz, sign, range);
+					oy = normalise_axial(y, _mm_loadu_ps(b.dz_y + l), sign, range);
+				}
+				else
+				{
+					const __m128 mag = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+					const __m128 live = _mm_cmpgt_ps(mag, dz);
+					if(mode == deadzone_radial)
+					{
+						ox = _mm_div_ps(x, range);
+						oy = _mm_div_ps(y, range);
+					}
+					else
+					{
+						// lanes with a zero magnitude divide to NaN here but are never live
+						__m128 s = _mm_div_ps(_mm_sub_ps(mag, dz), _mm_sub_ps(range, dz));
+						s = _mm_min_ps(s, one);
+						ox = _mm_mul_ps(_mm_div_ps(x, mag), s);
+						oy = _mm_mul_ps(_mm_div_ps(y, mag), s);
+					}
+					ox = _mm_and_ps(ox, live);
+					oy = _mm_and_ps(oy, live);
+				}
+				_mm_storeu_ps(b.x + l, ox);
+				_mm_storeu_ps(b.y + l, oy);
+				
+				const __m128 dz_t = _mm_loadu_ps(b.dz_t + l);
+				const __m128 t = _mm_sub_ps(_mm_loadu_ps(b.t + l), dz_t);
+				const __m128 t_live = _mm_cmpgt_ps(t, zero);
+				_mm_storeu_ps(b.t + l, _mm_and_ps(_mm_div_ps(t, _mm_sub_ps(trigger_range, dz_t)), t_live));
+			}
+		}
+#endif
+
+		typedef void (*lane_kernel)(axis_batch&, int, deadzone_mode);
+		
+		/// run kernel over states in batches of BatchStates
+		static void normalise(const gamepad_state* states, int count, const gamepad_config& config, 
+							  float* out, lane_kernel kernel)
+		{
+			axis_batch b;
+			while(count > 0)
+			{
+				int n = count < BatchStates ? count : BatchStates;
+				int lanes = gather(states, n, config, b);
+				kernel(b, lanes, config.mode);
+				scatter(b, n, out);
+				states += n;
+				out += n * gamepad_axis_count;
+				count -= n;
+			}
+		}
+	}
+	
+	/// normalise every axis of a batch of gamepad states
+	void normalise_gamepad_axes(const gamepad_state* states, int count, const gamepad_config& config, float* out)
+	{
+#if TYCHO_INPUT_SSE2
+		detail::normalise(states, count, config, out, &detail::normalise_lanes_sse);
+#else
+		detail::normalise(states, count, config, out, &detail::normalise_lanes_scalar);
+#endif
+	}
+
+	/// scalar version of normalise_gamepad_axes
+	void normalise_gamepad_axes_scalar(const gamepad_state* states, int count, const gamepad_config& config, float* out)
+	{
+		detail::normalise(states, count, config, out, &detail::normalise_lanes_scalar);
+	}
+
+} // end namespace
+} // end namespace
@@ -0,0 +1,46 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Sunday, 18 October 2026 03:12:48 PM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __AXIS_NORMALISER_H_6C2F8D41_9A3E_4B57_B0D8_E15A7C34F926_
+#define __AXIS_NORMALISER_H_6C2F8D41_9A3E_4B57_B0D8_E15A7C34F926_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+#include "input/gamepad_state.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+
+	/// normalise every axis of a batch of gamepad states. Sticks map to [-1,1] and
+	/// triggers to [0,1] using the deadzones and deadzone mode in config. States are
+	/// transposed into stick and trigger lanes and processed four at a time when
+	/// SSE2 is available.
+	/// \param states	states to normalise
+	/// \param count	number of states
+	/// \param out		count * gamepad_axis_count values, state i starts at out[i * gamepad_axis_count]
+	TYCHO_INPUT_ABI void normalise_gamepad_axes(const gamepad_state* states, int count, 
+												const gamepad_config& config, float* out);
+
+	/// scalar version of normalise_gamepad_axes. Gives bit identical results to the
+	/// vector path, in axial mode it also matches normalise_gamepad_axis exactly.
+	TYCHO_INPUT_ABI void normalise_gamepad_axes_scalar(const gamepad_state* states, int count, 
+													   const gamepad_config& config, float* out);
+
+} // end namespace
+} // end namespace
+
+#endif // __AXIS_NORMALISER_H_6C2F8D41_9A3E_4B57_B0D8_E15A7C34F926_
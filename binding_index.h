@@ -0,0 +1,148 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Saturday, 17 October 2026 01:02:38 PM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __BINDING_INDEX_H_5B93E0C7_1D4A_4E26_8F7B_A3C6D2E91048_
+#define __BINDING_INDEX_H_5B93E0C7_1D4A_4E26_8F7B_A3C6D2E91048_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+#include "input/types.h"
+#include "core/debug/assert.h"
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+
+	/// dense input codes. Every bindable input maps to a unique small integer so 
+	/// bindings can be resolved with a direct array lookup rather than hashing.
+	enum input_code
+	{
+		/// inputs that can't be bound (invalid / none)
+		input_code_none = 0,
+		
+		/// mouse movement
+		input_code_mouse,
+		
+		/// first axis code, indexed by axis_type
+		input_code_axis_base,
+		
+		/// first key code, indexed by key_type * key_state_count + key_state
+		input_code_key_base = input_code_axis_base + axis_count,
+		
+		/// number of input codes
+		input_code_count = input_code_key_base + key_count * key_state_count
+	};
+	
+	/// \returns the dense code of an input
+	inline int get_input_code(const input& i)
+	{
+		switch(i.event())
+		{
+			case event_type_mouse: return input_code_mouse;
+			case event_type_axis:  return input_code_axis_base + i.axis();
+			case event_type_key:   return input_code_key_base + i.key() * key_state_count + i.state();
+			default: return input_code_none;
+		}
+	}
+
+	/// table keyed on small dense integers with the same push / pop shadowing
+	/// semantics as core::scoped_hash_table. Pushing a key hides any existing 
+	/// value for it until it is popped again. Lookups are a direct index into
+	/// the head table followed by a load of the entry.
+	template<class T>
+	class scoped_index
+	{
+	public:
+		/// constructor
+		/// \param num_keys number of keys to reserve space for, the table grows if larger keys are pushed.
+		explicit scoped_index(int num_keys = 0) :
+			m_heads(num_keys, -1),
+			m_free(-1)
+		{}
+		
+		/// push a value for a key, shadowing any existing value.
+		void push(int key, const T& value)
+		{
+			TYCHO_ASSERT(key >= 0);
+			if(key >= (int)m_heads.size())
+				m_heads.resize(key + 1, -1);
+			int idx = m_free;
+			if(idx >= 0)
+			{
+				m_free = m_entries[idx].next;
+			}
+			else
+			{
+				idx = (int)m_entries.size();
+				m_entries.push_back(entry());
+			}
+			m_entries[idx].value = value;
+			m_entries[idx].next = m_heads[key];
+			m_heads[key] = idx;
+		}
+		
+		/// pop the most recently pushed value for a key, restoring the one it shadowed.
+		void pop(int key)
+		{
+			TYCHO_ASSERT(key >= 0 && key < (int)m_heads.size());
+			int idx = m_heads[key];
+			TYCHO_ASSERT(idx >= 0);
+			m_heads[key] = m_entries[idx].next;
+			m_entries[idx].next = m_free;
+			m_free = idx;
+		}
+		
+		/// \returns the current value for the key or 0 if none.
+		T* find(int key)
+		{
+			if((unsigned)key < m_heads.size())
+			{
+				int idx = m_heads[key];
+				if(idx >= 0)
+					return &m_entries[idx].value;
+			}
+			return 0;
+		}
+		
+		/// \returns the current value for the key or 0 if none.
+		const T* find(int key) const
+		{
+			return const_cast<scoped_index*>(this)->find(key);
+		}
+		
+		/// \returns the number of bytes of heap memory used by the table
+		size_t get_memory_usage() const
+		{
+			return m_heads.capacity() * sizeof(int) + m_entries.capacity() * sizeof(entry);
+		}
+		
+	private:
+		struct entry
+		{
+			T	value;
+			int next;	///< entry this one shadows, or next free entry when unused
+		};
+		
+		std::vector<int>	m_heads;	///< current entry per key, -1 if empty
+		std::vector<entry>	m_entries;	///< entry storage
+		int					m_free;		///< head of the entry free list
+	};
+
+} // end namespace
+} // end namespace
+
+#endif // __BINDING_INDEX_H_5B93E0C7_1D4A_4E26_8F7B_A3C6D2E91048_
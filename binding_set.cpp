@@ -0,0 +1,61 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Sunday, 18 October 2026 05:26:10 PM
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "binding_set.h"
+#include "input/name_table.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+namespace tycho
+{
+namespace input
+{
+
+	/// constructor, creates an empty set
+	binding_set::binding_set() :
+		m_num_bound(0)
+	{
+		for(int i = 0; i < input_code_count; ++i)
+			m_actions[i] = -1;
+	}
+	
+	/// compile a null terminated binding array
+	void binding_set::compile(const binding* bindings, name_table& names)
+	{
+		const binding* b = bindings;
+		while(b && b->action)
+		{
+			int code = get_input_code(b->trigger);
+			if(code != input_code_none)
+			{
+				if(m_actions[code] < 0)
+					++m_num_bound;
+				m_actions[code] = names.intern(b->action);
+			}
+			++b;
+		}
+	}
+	
+	/// remove the topmost occurrence of a set
+	void binding_layers::pop(const binding_set* set)
+	{
+		for(int i = (int)m_layers.size() - 1; i >= 0; --i)
+		{
+			if(m_layers[i] == set)
+			{
+				m_layers.erase(m_layers.begin() + i);
+				return;
+			}
+		}
+		TYCHO_ASSERT(!"binding set is not on the stack");
+	}
+
+} // end namespace
+} // end namespace
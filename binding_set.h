@@ -0,0 +1,101 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Sunday, 18 October 2026 05:26:10 PM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __BINDING_SET_H_E4A07C93_5B1D_4F62_8C3E_97D2B6F0A145_
+#define __BINDING_SET_H_E4A07C93_5B1D_4F62_8C3E_97D2B6F0A145_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+#include "input/types.h"
+#include "input/binding_index.h"
+#include "core/debug/assert.h"
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+	class name_table;
+
+	/// named set of bindings compiled once into a flat table indexed by input code.
+	/// Sets are immutable once compiled so device groups layer them by pointer,
+	/// pushing or popping a set is a single pointer operation however many 
+	/// bindings it holds.
+	class TYCHO_INPUT_ABI binding_set
+	{
+	public:
+		/// constructor, creates an empty set
+		binding_set();
+		
+		/// compile a null terminated binding array, action names are interned in names.
+		/// if an input is bound more than once the last binding wins.
+		void compile(const binding* bindings, name_table& names);
+		
+		/// \returns the interned id of the action bound to an input code or -1
+		int find(int input_code) const
+		{
+			TYCHO_ASSERT(input_code >= 0 && input_code < input_code_count);
+			return m_actions[input_code];
+		}
+		
+		/// \returns the number of inputs bound
+		int size() const { return m_num_bound; }
+		
+	private:
+		int m_actions[input_code_count];	///< action id per input code, -1 if unbound
+		int m_num_bound;
+	};
+	
+	/// stack of binding sets layered onto a device group. Lookups walk the layers 
+	/// from the top, each set is a single indexed load so the first set binding 
+	/// the input shadows those below it.
+	class TYCHO_INPUT_ABI binding_layers
+	{
+	public:
+		/// constructor
+		binding_layers() { m_layers.reserve(8); }
+		
+		/// push a set on top of the stack
+		void push(const binding_set* set) { m_layers.push_back(set); }
+		
+		/// remove the topmost occurrence of a set, normally the top of the stack
+		void pop(const binding_set* set);
+		
+		/// \returns the interned id of the action bound to an input code or -1
+		int find(int input_code) const
+		{
+			for(int i = (int)m_layers.size() - 1; i >= 0; --i)
+			{
+				int action_id = m_layers[i]->find(input_code);
+				if(action_id >= 0)
+					return action_id;
+			}
+			return -1;
+		}
+		
+		/// \returns number of sets on the stack
+		int size() const { return (int)m_layers.size(); }
+		
+		/// \returns the number of bytes used by the stack
+		size_t get_memory_usage() const { return m_layers.capacity() * sizeof(const binding_set*); }
+		
+	private:
+		std::vector<const binding_set*> m_layers;
+	};
+
+} // end namespace
+} // end namespace
+
+#endif // __BINDING_SET_H_E4A07C93_5B1D_4F62_8C3E_97D2B6F0A145_
@@ -0,0 +1,83 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Saturday, 17 October 2026 11:31:52 AM
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "capture_thread.h"
+#include <chrono>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+namespace tycho
+{
+namespace input
+{
+
+	/// constructor
+	capture_thread::capture_thread() :
+		m_rate_hz(DefaultRate),
+		m_quit(false),
+		m_num_updates(0)
+	{
+	}
+	
+	/// destructor, stops the thread if it is running.
+	capture_thread::~capture_thread()
+	{
+		stop();
+	}
+	
+	/// start polling the drivers
+	void capture_thread::start(const std::vector<driver_base*>& drivers, const std::vector<event_ring*>& rings, int rate_hz)
+	{
+		TYCHO_ASSERT(!is_running());
+		TYCHO_ASSERT(drivers.size() == rings.size());
+		TYCHO_ASSERT(rate_hz > 0);
+		m_drivers = drivers;
+		m_rings = rings;
+		m_rate_hz = rate_hz;
+		m_quit.store(false);
+		m_thread = std::thread(&capture_thread::run, this);
+	}
+	
+	/// stop polling and wait for the thread to exit
+	void capture_thread::stop()
+	{
+		if(!is_running())
+			return;
+		m_quit.store(true);
+		m_thread.join();
+		m_drivers.clear();
+		m_rings.clear();
+	}
+	
+	/// thread entry point
+	void capture_thread::run()
+	{
+		typedef std::chrono::steady_clock clock;
+		const clock::duration period = std::chrono::duration_cast<clock::duration>(std::chrono::seconds(1)) / m_rate_hz;
+		clock::time_point next = clock::now();
+		while(!m_quit.load(std::memory_order_relaxed))
+		{
+			for(size_t i = 0; i < m_drivers.size(); ++i)
+				m_drivers[i]->update(m_rings[i]);
+			m_num_updates.fetch_add(1, std::memory_order_relaxed);
+			
+			// schedule against absolute times so the rate doesn't drift, if we 
+			// fall behind skip the missed ticks rather than trying to catch up.
+			next += period;
+			clock::time_point now = clock::now();
+			if(next < now)
+				next = now;
+			else
+				std::this_thread::sleep_until(next);
+		}
+	}
+
+} // end namespace
+} // end namespace
@@ -0,0 +1,80 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Saturday, 17 October 2026 11:31:52 AM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __CAPTURE_THREAD_H_E15B7C93_6A0D_4F28_B3C4_9D72A1E8056F_
+#define __CAPTURE_THREAD_H_E15B7C93_6A0D_4F28_B3C4_9D72A1E8056F_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+#include "input/driver_base.h"
+#include "input/event_ring.h"
+#include <vector>
+#include <thread>
+#include <atomic>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+
+	/// dedicated thread that polls a set of drivers at a fixed rate. Each driver 
+	/// writes into its own event_ring so the thread is the single producer of that
+	/// ring and the game thread draining it is the single consumer. Drivers that
+	/// only expose their current state (xinput) are sampled far more often than
+	/// the game updates so short presses between frames are not lost.
+	class TYCHO_INPUT_ABI capture_thread
+	{
+	public:
+		static const int DefaultRate = 1000;
+
+		/// constructor
+		capture_thread();
+
+		/// destructor, stops the thread if it is running.
+		~capture_thread();
+
+		/// start polling the drivers, each driver is updated into the ring at the same index.
+		/// \param rate_hz number of times per second to update the drivers.
+		void start(const std::vector<driver_base*>& drivers, const std::vector<event_ring*>& rings, int rate_hz);
+
+		/// stop polling and wait for the thread to exit
+		void stop();
+
+		/// \returns true if the thread is running
+		bool is_running() const { return m_thread.joinable(); }
+
+		/// \returns the number of completed polling passes.
+		core::uint32 get_num_updates() const { return m_num_updates.load(std::memory_order_relaxed); }
+
+	private:
+		/// non copyable
+		capture_thread(const capture_thread&);
+		void operator=(const capture_thread&);
+
+		/// thread entry point
+		void run();
+
+		std::vector<driver_base*>	m_drivers;
+		std::vector<event_ring*>	m_rings;
+		int							m_rate_hz;
+		std::thread					m_thread;
+		std::atomic<bool>			m_quit;
+		std::atomic<core::uint32>	m_num_updates;
+	};
+
+} // end namespace
+} // end namespace
+
+#endif // __CAPTURE_THREAD_H_E15B7C93_6A0D_4F28_B3C4_9D72A1E8056F_
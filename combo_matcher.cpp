@@ -0,0 +1,241 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Monday, 19 October 2026 01:37:04 PM
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "combo_matcher.h"
+#include "input/name_table.h"
+#include <algorithm>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+namespace tycho
+{
+namespace input
+{
+
+	namespace detail
+	{
+		/// \returns number of keys in a mask
+		int count_keys(const key_mask& m)
+		{
+			int n = 0;
+			for(int i = 0; i < key_mask::Words; ++i)
+				for(core::uint64 b = m.bits[i]; b; b &= b - 1)
+					++n;
+			return n;
+		}
+
+		/// combo waiting to be sorted into its set
+		struct sort_entry
+		{
+			key_type			trigger;
+			int					num_modifiers;
+			int					order;		///< position in the source array, keeps the sort stable
+			combo_set::entry	entry;
+
+			bool operator<(const sort_entry& rhs) const
+			{
+				if(trigger != rhs.trigger)
+					return trigger < rhs.trigger;
+				if(num_modifiers != rhs.num_modifiers)
+					return num_modifiers > rhs.num_modifiers;
+				return order < rhs.order;
+			}
+		};
+	}
+
+	//////////////////////////////////////////////////////////////////////////////
+	// combo_set
+	//////////////////////////////////////////////////////////////////////////////
+
+	/// constructor, creates an empty set
+	combo_set::combo_set()
+	{
+		for(int i = 0; i <= key_count; ++i)
+			m_first[i] = 0;
+	}
+
+	/// compile a null terminated combo array
+	void combo_set::compile(const combo* combos, name_table& names)
+	{
+		std::vector<detail::sort_entry> sorted;
+		for(const combo* c = combos; c && c->action; ++c)
+		{
+			if(c->trigger <= key_invalid || c->trigger >= key_count)
+				continue;
+			detail::sort_entry s;
+			s.trigger = c->trigger;
+			s.order = (int)sorted.size();
+			s.entry.modifiers.reset();
+			for(int i = 0; i < combo::MaxModifiers; ++i)
+			{
+				if(c->modifiers[i] > key_invalid && c->modifiers[i] < key_count && c->modifiers[i] != c->trigger)
+					s.entry.modifiers.set(c->modifiers[i]);
+			}
+			s.num_modifiers = detail::count_keys(s.entry.modifiers);
+			s.entry.type = c->type;
+			s.entry.action_id = names.intern(c->action);
+			s.entry.time_ns = (core::int64)c->time_ms * 1000000;
+			sorted.push_back(s);
+		}
+		std::sort(sorted.begin(), sorted.end());
+
+		m_entries.clear();
+		m_entries.reserve(sorted.size());
+		int cur = 0;
+		for(int k = 0; k < key_count; ++k)
+		{
+			m_first[k] = (int)m_entries.size();
+			while(cur < (int)sorted.size() && sorted[cur].trigger == k)
+				m_entries.push_back(sorted[cur++].entry);
+		}
+		m_first[key_count] = (int)m_entries.size();
+	}
+
+	//////////////////////////////////////////////////////////////////////////////
+	// combo_matcher
+	//////////////////////////////////////////////////////////////////////////////
+
+	/// constructor
+	combo_matcher::combo_matcher() :
+		m_num_holds(0)
+	{
+		m_layers.reserve(8);
+		m_held.reset();
+		m_tapped.reset();
+		for(int i = 0; i < key_count; ++i)
+			m_last_down[i] = 0;
+	}
+
+	/// remove the topmost occurrence of a set
+	void combo_matcher::pop(const combo_set* set)
+	{
+		for(int i = (int)m_layers.size() - 1; i >= 0; --i)
+		{
+			if(m_layers[i] == set)
+			{
+				m_layers.erase(m_layers.begin() + i);
+
+				// holds only complete while their set is on the stack
+				int n = 0;
+				for(int h = 0; h < m_num_holds; ++h)
+				{
+					if(m_holds[h].set != set)
+						m_holds[n++] = m_holds[h];
+				}
+				m_num_holds = n;
+				return;
+			}
+		}
+		TYCHO_ASSERT(!"combo set is not on the stack");
+	}
+
+	/// a key went down. The topmost set with a combo on the key whose modifiers
+	/// are held handles it, sets below are shadowed the same way bindings are.
+	int combo_matcher::key_down(key_type k, core::int64 timestamp, match* out, bool& consumed)
+	{
+		consumed = false;
+		if(k <= key_invalid || k >= key_count)
+			return 0;
+
+		m_held.set(k);
+		bool can_double_tap = m_tapped.test(k) && timestamp >= m_last_down[k];
+		bool double_tapped = false;
+		bool handled = false;
+		int num_matches = 0;
+		for(int l = (int)m_layers.size() - 1; l >= 0 && !handled; --l)
+		{
+			const combo_set* set = m_layers[l];
+			const combo_set::entry* end = set->end(k);
+			for(const combo_set::entry* e = set->begin(k); e != end; ++e)
+			{
+				if(!m_held.contains(e->modifiers))
+					continue;
+				handled = true;
+				bool matched = false;
+				switch(e->type)
+				{
+					case combo_chord:
+						// only the most specific chord, they're sorted by number of modifiers
+						matched = !consumed;
+						consumed = true;
+						break;
+					case combo_double_tap:
+						if(can_double_tap && timestamp - m_last_down[k] <= e->time_ns)
+						{
+							matched = true;
+							double_tapped = true;
+						}
+						break;
+					case combo_hold:
+						if(m_num_holds < MaxHolds)
+						{
+							hold h = { e, set, k, timestamp };
+							m_holds[m_num_holds++] = h;
+						}
+						break;
+				}
+				if(matched && num_matches < MaxMatches)
+				{
+					match m = { e->action_id, k, timestamp };
+					out[num_matches++] = m;
+				}
+			}
+		}
+
+		// a completed double tap can't also start the next one
+		if(double_tapped)
+			m_tapped.clear(k);
+		else
+			m_tapped.set(k);
+		m_last_down[k] = timestamp;
+		return num_matches;
+	}
+
+	/// a key went up, cancels holds on it
+	void combo_matcher::key_up(key_type k)
+	{
+		if(k <= key_invalid || k >= key_count)
+			return;
+		m_held.clear(k);
+		int n = 0;
+		for(int h = 0; h < m_num_holds; ++h)
+		{
+			if(m_holds[h].key != k)
+				m_holds[n++] = m_holds[h];
+		}
+		m_num_holds = n;
+	}
+
+	/// complete holds that have lasted long enough, in the order they started
+	int combo_matcher::update(core::int64 now, match* out)
+	{
+		int num_matches = 0;
+		int n = 0;
+		for(int h = 0; h < m_num_holds; ++h)
+		{
+			const hold& cur = m_holds[h];
+			if(now - cur.start < cur.combo->time_ns || num_matches == MaxMatches)
+			{
+				m_holds[n++] = cur;
+				continue;
+			}
+			// the trigger is still down or the hold would have been cancelled, modifiers may not be
+			if(m_held.contains(cur.combo->modifiers))
+			{
+				match m = { cur.combo->action_id, cur.key, cur.start + cur.combo->time_ns };
+				out[num_matches++] = m;
+			}
+		}
+		m_num_holds = n;
+		return num_matches;
+	}
+
+} // end namespace
+} // end namespace
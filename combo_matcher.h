@@ -0,0 +1,165 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Monday, 19 October 2026 01:37:04 PM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __COMBO_MATCHER_H_91C5E7A2_3D48_4B6F_A0E9_C62F1B8D5037_
+#define __COMBO_MATCHER_H_91C5E7A2_3D48_4B6F_A0E9_C62F1B8D5037_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+#include "input/types.h"
+#include "core/debug/assert.h"
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+	class name_table;
+
+	/// set of keys, one bit per key_type
+	struct key_mask
+	{
+		static const int Words = (key_count + 63) / 64;
+
+		core::uint64 bits[Words];
+
+		/// clear all keys
+		void reset() { for(int i = 0; i < Words; ++i) bits[i] = 0; }
+
+		/// \returns true if the key is in the set
+		bool test(key_type k) const { return ((bits[k >> 6] >> (k & 63)) & 1) != 0; }
+
+		/// add a key
+		void set(key_type k) { bits[k >> 6] |= (core::uint64)1 << (k & 63); }
+
+		/// remove a key
+		void clear(key_type k) { bits[k >> 6] &= ~((core::uint64)1 << (k & 63)); }
+
+		/// \returns true if every key in other is also in this set
+		bool contains(const key_mask& other) const
+		{
+			for(int i = 0; i < Words; ++i)
+				if((bits[i] & other.bits[i]) != other.bits[i])
+					return false;
+			return true;
+		}
+	};
+
+	/// named set of combos compiled into a table grouped by trigger key. Like
+	/// binding_set it is immutable once compiled and layered by pointer.
+	class TYCHO_INPUT_ABI combo_set
+	{
+	public:
+		/// compiled combo
+		struct entry
+		{
+			key_mask	modifiers;	///< keys that must be held
+			combo_type	type;
+			int			action_id;	///< interned action id
+			core::int64	time_ns;	///< double tap window or hold time
+		};
+
+		/// constructor, creates an empty set
+		combo_set();
+
+		/// compile a null terminated combo array, action names are interned in names.
+		void compile(const combo* combos, name_table& names);
+
+		/// \returns the first combo triggered by a key. Combos with more modifiers
+		///			 come first so the most specific chord is found first.
+		const entry* begin(key_type k) const { return m_entries.empty() ? 0 : &m_entries[0] + m_first[k]; }
+
+		/// \returns one past the last combo triggered by a key
+		const entry* end(key_type k) const { return m_entries.empty() ? 0 : &m_entries[0] + m_first[k + 1]; }
+
+		/// \returns the number of combos in the set
+		int size() const { return (int)m_entries.size(); }
+
+	private:
+		std::vector<entry>	m_entries;				///< sorted by trigger
+		int					m_first[key_count + 1];	///< first entry per trigger key
+	};
+
+	/// incremental matcher for the combos layered onto a device group. Held keys are
+	/// kept as a key_mask so matching a key press is a mask compare against each
+	/// combo on that key, no other combos or bindings are looked at. Holds in
+	/// progress are kept in a small fixed list checked once per update.
+	class TYCHO_INPUT_ABI combo_matcher
+	{
+	public:
+		/// matched combo
+		struct match
+		{
+			int			action_id;
+			key_type	key;
+			core::int64	timestamp;	///< time the combo completed, for holds when the hold time ran out rather than when update noticed
+		};
+
+		static const int MaxMatches = 8;	///< most matches reported for a single call
+		static const int MaxHolds = 16;		///< most holds tracked at once, extra holds are ignored
+
+		/// constructor
+		combo_matcher();
+
+		/// push a set on top of the stack, sets higher up are matched first
+		void push(const combo_set* set) { m_layers.push_back(set); }
+
+		/// remove the topmost occurrence of a set, holds from it in progress are cancelled
+		void pop(const combo_set* set);
+
+		/// \returns true if there are no combo sets on the stack
+		bool empty() const { return m_layers.empty(); }
+
+		/// a key went down.
+		/// \param out receives up to MaxMatches combos completed by the press.
+		/// \param consumed set to true if a chord matched so the press shouldn't trigger its plain binding
+		/// \returns number of matches written to out
+		int key_down(key_type k, core::int64 timestamp, match* out, bool& consumed);
+
+		/// a key went up, cancels holds on it
+		void key_up(key_type k);
+
+		/// \returns true if any holds are in progress
+		bool has_holds() const { return m_num_holds > 0; }
+
+		/// complete holds that have lasted long enough
+		/// \returns number of matches written to out
+		int update(core::int64 now, match* out);
+
+		/// \returns number of bytes used by the matcher, combo sets are not included
+		size_t get_memory_usage() const { return sizeof(combo_matcher) + m_layers.capacity() * sizeof(const combo_set*); }
+
+	private:
+		/// hold waiting for its time to elapse
+		struct hold
+		{
+			const combo_set::entry* combo;
+			const combo_set*		set;
+			key_type				key;
+			core::int64				start;
+		};
+
+		std::vector<const combo_set*>	m_layers;
+		key_mask	m_held;							///< keys currently down
+		key_mask	m_tapped;						///< keys whose last press can start a double tap
+		core::int64	m_last_down[key_count];			///< time of each key's last press
+		hold		m_holds[MaxHolds];
+		int			m_num_holds;
+	};
+
+} // end namespace
+} // end namespace
+
+#endif // __COMBO_MATCHER_H_91C5E7A2_3D48_4B6F_A0E9_C62F1B8D5037_
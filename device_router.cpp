@@ -0,0 +1,68 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Saturday, 17 October 2026 09:12:41 AM
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "device_router.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+namespace tycho
+{
+namespace input
+{
+
+	/// constructor
+	device_router::device_router()
+	{
+	}
+
+	/// route a device to a group, replaces any existing route for the device.
+	void device_router::set_group(int device_id, int group)
+	{
+		get(device_id).group = group;
+	}
+	
+	/// remove the group route for a device, does nothing if it is not routed.
+	void device_router::clear(int device_id)
+	{
+		int driver_id, device_num;
+		split_device_id(device_id, &driver_id, &device_num);
+		if((unsigned)driver_id < m_drivers.size())
+		{
+			routes& r = m_drivers[driver_id];
+			if((unsigned)device_num < r.size())
+				r[device_num].group = -1;
+		}
+	}
+	
+	/// set the slot the device occupies in the device list
+	void device_router::set_slot(int device_id, int slot)
+	{
+		get(device_id).slot = slot;
+	}
+	
+	/// \returns the route for a device, adding it if needed
+	device_router::route& device_router::get(int device_id)
+	{
+		int driver_id, device_num;
+		split_device_id(device_id, &driver_id, &device_num);
+		TYCHO_ASSERT(driver_id >= 0);
+		if((unsigned)driver_id >= m_drivers.size())
+			m_drivers.resize(driver_id + 1);
+		routes& r = m_drivers[driver_id];
+		if((unsigned)device_num >= r.size())
+		{
+			route none = { -1, -1 };
+			r.resize(device_num + 1, none);
+		}
+		return r[device_num];
+	}
+
+} // end namespace
+} // end namespace
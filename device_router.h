@@ -0,0 +1,89 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Saturday, 17 October 2026 09:12:41 AM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __DEVICE_ROUTER_H_3C1F7A52_8E4B_4D0A_9B7E_61A2D5C0F4E8_
+#define __DEVICE_ROUTER_H_3C1F7A52_8E4B_4D0A_9B7E_61A2D5C0F4E8_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+#include "input/driver_base.h"
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+
+	/// dense routing table from device id to the device group it is bound to and
+	/// the slot it occupies in the interface's device list. Device ids are split 
+	/// into their (driver_id, device_num) halves and used to index directly into 
+	/// a per driver table so a lookup is two indexed loads.
+	class TYCHO_INPUT_ABI device_router
+	{
+	public:
+		/// routing information for a single device
+		struct route
+		{
+			int group;	///< group the device is bound to or -1
+			int slot;	///< index of the device in the device list or -1
+		};
+		
+		/// constructor
+		device_router();
+
+		/// route a device to a group, replaces any existing route for the device.
+		void set_group(int device_id, int group);
+
+		/// remove the group route for a device, does nothing if it is not routed.
+		void clear(int device_id);
+		
+		/// set the slot the device occupies in the device list
+		void set_slot(int device_id, int slot);
+
+		/// \returns the route for the device, both fields are -1 for unknown devices.
+		route find(int device_id) const
+		{
+			int driver_id, device_num;
+			split_device_id(device_id, &driver_id, &device_num);
+			if((unsigned)driver_id < m_drivers.size())
+			{
+				const routes& r = m_drivers[driver_id];
+				if((unsigned)device_num < r.size())
+					return r[device_num];
+			}
+			route none = { -1, -1 };
+			return none;
+		}
+		
+		/// \returns the group the device is routed to or -1 if it is not bound.
+		int find_group(int device_id) const
+		{
+			return find(device_id).group;
+		}
+
+	private:
+		/// \returns the route for a device, adding it if needed
+		route& get(int device_id);
+		
+		typedef std::vector<route> routes;
+		typedef std::vector<routes> driver_routes;
+
+		driver_routes m_drivers;	///< per driver table of routes indexed by device number
+	};
+
+} // end namespace
+} // end namespace
+
+#endif // __DEVICE_ROUTER_H_3C1F7A52_8E4B_4D0A_9B7E_61A2D5C0F4E8_
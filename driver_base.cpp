@@ -18,6 +18,18 @@ namespace tycho
 namespace input
 {
 
+	/// \returns the description of a connected device or 0
+	const device_description* driver_base::find_device_desc(int device_id) const
+	{
+		int num_devices = get_num_devices();
+		for(int i = 0; i < num_devices; ++i)
+		{
+			const device_description* desc = get_device_desc(i);
+			if(desc && desc->id == device_id)
+				return desc;
+		}
+		return 0;
+	}
 
 } // end namespace
 } // end namespace
@@ -26,7 +26,10 @@ namespace tycho
 namespace input
 {
 
-	/// base of all input drivers. 
+	/// base of all input drivers. Drivers that support hot plugging report devices
+	/// coming and going through the event handler from update(), after which 
+	/// get_num_devices and get_device_desc reflect the connected set. Descriptions
+	/// must stay valid and unchanged while their device is connected.
 	class TYCHO_INPUT_ABI driver_base
     {
     public:
@@ -35,6 +38,8 @@ namespace input
 			virtual void handle_mouse_event(int /*device_id*/, const mouse_packet&) {}
 			virtual void handle_keyboard_event(int /*device_id*/, const keyboard_packet&) {}
 			virtual void handle_axis_event(int /*device_id*/, const axis_packet&) {}
+			virtual void handle_device_added(const device_description&) {}
+			virtual void handle_device_removed(int /*device_id*/) {}
 		};
 		
     public:
@@ -52,6 +57,10 @@ namespace input
 		
 		/// \returns the i'th device 
 		virtual const device_description* get_device_desc(int i) const = 0;
+		
+		/// \returns the description of a connected device or 0. The default searches
+		/// get_device_desc, drivers with many devices should override it.
+		virtual const device_description* find_device_desc(int device_id) const;
     };
 
 	/// construct a device id from a driver id and device number
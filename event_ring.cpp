@@ -0,0 +1,152 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Saturday, 17 October 2026 10:03:17 AM
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "event_ring.h"
+#include "input/timestamp.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+namespace tycho
+{
+namespace input
+{
+
+	/// constructor
+	event_ring::event_ring(int capacity) :
+		m_packets(0),
+		m_mask(0),
+		m_head(0),
+		m_cached_tail(0),
+		m_num_dropped(0),
+		m_high_water(0),
+		m_tail(0)
+	{
+		TYCHO_ASSERT(capacity > 0);
+		int size = 1;
+		while(size < capacity)
+			size <<= 1;
+		m_packets = new event_packet[size];
+		m_mask = size - 1;
+	}
+	
+	/// destructor
+	event_ring::~event_ring()
+	{
+		delete[] m_packets;
+	}
+	
+	/// append a packet to the ring
+	bool event_ring::push(const event_packet& pkt)
+	{
+		core::uint32 head = m_head.load(std::memory_order_relaxed);
+		core::uint32 pending = head - m_cached_tail;
+		if(pending > (core::uint32)m_mask)
+		{
+			// looks full, refresh our view of the consumer
+			m_cached_tail = m_tail.load(std::memory_order_acquire);
+			pending = head - m_cached_tail;
+			if(pending > (core::uint32)m_mask)
+			{
+				m_num_dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+		}
+		m_packets[head & m_mask] = pkt;
+		m_head.store(head + 1, std::memory_order_release);
+		if(pending + 1 > m_high_water.load(std::memory_order_relaxed))
+			m_high_water.store(pending + 1, std::memory_order_relaxed);
+		return true;
+	}
+	
+	void event_ring::handle_mouse_event(int device_id, const mouse_packet& mouse)
+	{
+		event_packet pkt;
+		pkt.timestamp = get_timestamp();
+		pkt.index = device_id;
+		pkt.ptype = packet_type_mouse;
+		pkt.mouse = mouse;
+		push(pkt);
+	}
+	
+	void event_ring::handle_keyboard_event(int device_id, const keyboard_packet& keyboard)
+	{
+		event_packet pkt;
+		pkt.timestamp = get_timestamp();
+		pkt.index = device_id;
+		pkt.ptype = packet_type_keyboard;
+		pkt.keyboard = keyboard;
+		push(pkt);
+	}
+	
+	void event_ring::handle_axis_event(int device_id, const axis_packet& axis)
+	{
+		event_packet pkt;
+		pkt.timestamp = get_timestamp();
+		pkt.index = device_id;
+		pkt.ptype = packet_type_axis;
+		pkt.axis = axis;
+		push(pkt);
+	}
+	
+	void event_ring::handle_device_added(const device_description& desc)
+	{
+		event_packet pkt;
+		pkt.timestamp = get_timestamp();
+		pkt.index = desc.id;
+		pkt.ptype = packet_type_device_added;
+		pkt.device = make_device_packet(desc);
+		push(pkt);
+	}
+	
+	void event_ring::handle_device_removed(int device_id)
+	{
+		event_packet pkt;
+		pkt.timestamp = get_timestamp();
+		pkt.index = device_id;
+		pkt.ptype = packet_type_device_removed;
+		pkt.device.type = device_unknown;
+		pkt.device.index = -1;
+		push(pkt);
+	}
+	
+	/// get all packets currently in the ring. 
+	int event_ring::acquire(span out_spans[2]) const
+	{
+		core::uint32 tail = m_tail.load(std::memory_order_relaxed);
+		core::uint32 head = m_head.load(std::memory_order_acquire);
+		int count = (int)(head - tail);
+		if(count == 0)
+			return 0;
+		
+		int first = (int)(tail & m_mask);
+		int size = m_mask + 1;
+		if(first + count <= size)
+		{
+			out_spans[0].packets = m_packets + first;
+			out_spans[0].count = count;
+			return 1;
+		}
+		out_spans[0].packets = m_packets + first;
+		out_spans[0].count = size - first;
+		out_spans[1].packets = m_packets;
+		out_spans[1].count = count - out_spans[0].count;
+		return 2;
+	}
+	
+	/// release the first count acquired packets back to the producer.
+	void event_ring::release(int count)
+	{
+		core::uint32 tail = m_tail.load(std::memory_order_relaxed);
+		TYCHO_ASSERT((int)(m_head.load(std::memory_order_relaxed) - tail) >= count);
+		m_tail.store(tail + count, std::memory_order_release);
+	}
+
+} // end namespace
+} // end namespace
@@ -0,0 +1,114 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Saturday, 17 October 2026 10:03:17 AM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __EVENT_RING_H_7D2E9B14_5A63_4C8F_A0D1_2F84B6E3C957_
+#define __EVENT_RING_H_7D2E9B14_5A63_4C8F_A0D1_2F84B6E3C957_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+#include "input/types.h"
+#include "input/driver_base.h"
+#include <atomic>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+
+	/// bounded lock free single producer / single consumer ring of event packets.
+	/// the producer is a driver which sees the ring as a regular event handler, each
+	/// event it generates is appended as a packet with the device id in event_packet::index
+	/// and stamped with the time it was captured.
+	/// the consumer drains the ring in batches via acquire / release. If the ring is full
+	/// new packets are dropped and counted.
+	class TYCHO_INPUT_ABI event_ring :
+		public driver_base::event_handler
+	{
+	public:
+		/// contiguous run of packets handed out to the consumer
+		struct span
+		{
+			const event_packet* packets;
+			int					count;
+		};
+
+		static const int DefaultCapacity = 1024;
+
+		/// constructor
+		/// \param capacity maximum number of pending packets, rounded up to a power of 2.
+		explicit event_ring(int capacity = DefaultCapacity);
+
+		/// destructor
+		virtual ~event_ring();
+
+		/// \name producer interface
+		//@{
+		/// append a packet to the ring
+		/// \returns false if the ring was full and the packet was dropped
+		bool push(const event_packet& pkt);
+
+		virtual void handle_mouse_event(int device_id, const mouse_packet&);
+		virtual void handle_keyboard_event(int device_id, const keyboard_packet&);
+		virtual void handle_axis_event(int device_id, const axis_packet&);
+		virtual void handle_device_added(const device_description& desc);
+		virtual void handle_device_removed(int device_id);
+		//@}
+
+		/// \name consumer interface
+		//@{
+		/// get all packets currently in the ring. as the ring wraps these may be
+		/// split into two spans which must be processed in order.
+		/// \returns the number of spans written to out_spans, 0 if the ring is empty.
+		int acquire(span out_spans[2]) const;
+
+		/// release the first count acquired packets back to the producer.
+		void release(int count);
+		//@}
+
+		/// \returns the maximum number of pending packets
+		int get_capacity() const { return m_mask + 1; }
+
+		/// \returns the number of packets dropped because the ring was full
+		core::uint32 get_num_dropped() const { return m_num_dropped.load(std::memory_order_relaxed); }
+
+		/// \returns the largest number of packets that have been pending at once
+		core::uint32 get_high_water() const { return m_high_water.load(std::memory_order_relaxed); }
+
+	private:
+		/// non copyable
+		event_ring(const event_ring&);
+		void operator=(const event_ring&);
+
+		static const int CacheLineSize = 64;
+
+		event_packet* m_packets;
+		int			  m_mask;
+
+		// producer and consumer indices are free running and kept on separate
+		// cache lines so the two threads don't contend.
+		char						m_pad0[CacheLineSize];
+		std::atomic<core::uint32>	m_head;			///< next slot to write, owned by the producer
+		core::uint32				m_cached_tail;	///< producer's last view of m_tail
+		std::atomic<core::uint32>	m_num_dropped;
+		std::atomic<core::uint32>	m_high_water;
+		char						m_pad1[CacheLineSize];
+		std::atomic<core::uint32>	m_tail;			///< next slot to read, owned by the consumer
+		char						m_pad2[CacheLineSize];
+	};
+
+} // end namespace
+} // end namespace
+
+#endif // __EVENT_RING_H_7D2E9B14_5A63_4C8F_A0D1_2F84B6E3C957_
@@ -0,0 +1,193 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Sunday, 18 October 2026 01:37:26 PM
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "gamepad_state.h"
+#include "input/intrinsics.h"
+#include "input/axis_normaliser.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+namespace tycho
+{
+namespace input
+{
+
+	namespace detail
+	{
+		/// key for each gamepad_button bit
+		static constexpr key_type ButtonKeys[16] = {
+			key_button_dpad_up,
+			key_button_dpad_down,
+			key_button_dpad_left,
+			key_button_dpad_right,
+			key_button_start,
+			key_button_back,
+			key_button_left_thumb,
+			key_button_right_thumb,
+			key_button_left_shoulder,
+			key_button_right_shoulder,
+			key_invalid,
+			key_invalid,
+			key_button_a,
+			key_button_b,
+			key_button_x,
+			key_button_y
+		};
+		
+		/// axis for each gamepad_axis
+		static constexpr axis_type Axes[gamepad_axis_count] = {
+			axis_lthumb_x,
+			axis_lthumb_y,
+			axis_rthumb_x,
+			axis_rthumb_y,
+			axis_ltrigger_x,
+			axis_rtrigger_x
+		};
+		
+		static_assert(gamepad_axis_count <= gamepad_state::NumAxisSlots, "gamepad axes don't fit in the state");
+	}
+	
+	/// \returns the default XInput deadzones
+	gamepad_config gamepad_config::make_default()
+	{
+		// XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE, XINPUT_GAMEPAD_RIGHT_THUMB_DEADZONE, XINPUT_GAMEPAD_TRIGGER_THRESHOLD
+		gamepad_config c = { deadzone_axial, { 7849, 7849, 8689, 8689, 30, 30 } };
+		return c;
+	}
+	
+	/// \returns an all zero gamepad state
+	gamepad_state make_gamepad_state()
+	{
+		gamepad_state s;
+		core::mem_zero(s);
+		return s;
+	}
+	
+	/// \returns which buttons and axes changed between two states
+	gamepad_diff diff_gamepad_state(const gamepad_state& prev, const gamepad_state& cur)
+	{
+		gamepad_diff d;
+		core::uint32 changed = prev.buttons ^ cur.buttons;
+		d.pressed = changed & cur.buttons;
+		d.released = changed & prev.buttons;
+		
+#if TYCHO_INPUT_SSE2
+		// compare all axes at once, the mask has 2 bits per differing 16 bit lane
+		__m128i a = _mm_loadu_si128((const __m128i*)prev.axes);
+		__m128i b = _mm_loadu_si128((const __m128i*)cur.axes);
+		core::uint32 lanes = ~(core::uint32)_mm_movemask_epi8(_mm_cmpeq_epi16(a, b)) & 0xffff;
+		core::uint32 axes = 0;
+		while(lanes)
+		{
+			int lane = count_trailing_zeros(lanes) >> 1;
+			axes |= 1u << lane;
+			lanes &= ~(3u << (lane * 2));
+		}
+		d.axes = axes;
+#else
+		d.axes = 0;
+		for(int i = 0; i < gamepad_axis_count; ++i)
+		{
+			if(prev.axes[i] != cur.axes[i])
+				d.axes |= 1u << i;
+		}
+#endif
+		return d;
+	}
+	
+	/// \returns the key a gamepad button bit maps to
+	key_type get_gamepad_key(int bit)
+	{
+		if(bit < 0 || bit >= 16)
+			return key_invalid;
+		return detail::ButtonKeys[bit];
+	}
+	
+	/// \returns the axis a gamepad axis maps to
+	axis_type get_gamepad_axis(gamepad_axis a)
+	{
+		return detail::Axes[a];
+	}
+	
+	/// \returns the normalised value of a gamepad axis
+	float normalise_gamepad_axis(gamepad_axis a, int val, int deadzone)
+	{
+		if(a == gamepad_axis_ltrigger || a == gamepad_axis_rtrigger)
+		{
+			if(val <= deadzone)
+				return 0;
+			return ((float)(val - deadzone)) / (255 - deadzone);
+		}
+		
+		// clamp to the deadzone and scale the remaining range into [0,1]
+		if(val >= 0 && val < deadzone)
+			val = 0;
+		else if(val < 0 && val >= -deadzone)
+			val = 0;
+		else if (val < 0)
+			val += deadzone;
+		else 
+			val -= deadzone;
+			
+		return ((float)val) / (32768 - deadzone);
+	}
+	
+	/// generate the key and axis events for the change between two states
+	void emit_gamepad_events(int device_id, const gamepad_state& prev, const gamepad_state& cur,
+							 const gamepad_config& config, driver_base::event_handler* handler)
+	{
+		float normalised[gamepad_axis_count];
+		normalise_gamepad_axes(&cur, 1, config, normalised);
+		emit_gamepad_events(device_id, prev, cur, normalised, config, handler);
+	}
+	
+	/// as above using axis values already normalised with normalise_gamepad_axes
+	void emit_gamepad_events(int device_id, const gamepad_state& prev, const gamepad_state& cur,
+							 const float* normalised, const gamepad_config& config, 
+							 driver_base::event_handler* handler)
+	{
+		gamepad_diff d = diff_gamepad_state(prev, cur);
+		
+		// visit only the buttons that changed, lowest bit first
+		core::uint32 changed = d.pressed | d.released;
+		while(changed)
+		{
+			int bit = count_trailing_zeros(changed);
+			changed &= changed - 1;
+			key_type key = detail::ButtonKeys[bit & 15];
+			if(key == key_invalid)
+				continue;
+			key_state state = (d.pressed >> bit) & 1 ? key_state_down : key_state_up;
+			handler->handle_keyboard_event(device_id, make_keyboard_packet(key, state));
+		}
+		
+		// with radial deadzones either component of a stick changes both outputs
+		core::uint32 axes = d.axes;
+		if(config.mode != deadzone_axial)
+		{
+			const core::uint32 LeftStick = (1u << gamepad_axis_lthumb_x) | (1u << gamepad_axis_lthumb_y);
+			const core::uint32 RightStick = (1u << gamepad_axis_rthumb_x) | (1u << gamepad_axis_rthumb_y);
+			if(axes & LeftStick)
+				axes |= LeftStick;
+			if(axes & RightStick)
+				axes |= RightStick;
+		}
+		while(axes)
+		{
+			gamepad_axis a = (gamepad_axis)count_trailing_zeros(axes);
+			axes &= axes - 1;
+			if(a >= gamepad_axis_count)
+				continue;
+			handler->handle_axis_event(device_id, make_axis_packet(detail::Axes[a], normalised[a]));
+		}
+	}
+
+} // end namespace
+} // end namespace
@@ -0,0 +1,133 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Sunday, 18 October 2026 01:37:26 PM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __GAMEPAD_STATE_H_0B6E3A97_F582_4D1C_A7E4_28C5D91B063F_
+#define __GAMEPAD_STATE_H_0B6E3A97_F582_4D1C_A7E4_28C5D91B063F_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+#include "input/types.h"
+#include "input/driver_base.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+
+	/// gamepad button bits. These match the XInput wButtons layout so xinput
+	/// states can be used directly, other drivers translate into them.
+	enum gamepad_button
+	{
+		gamepad_dpad_up			= 0x0001,
+		gamepad_dpad_down		= 0x0002,
+		gamepad_dpad_left		= 0x0004,
+		gamepad_dpad_right		= 0x0008,
+		gamepad_start			= 0x0010,
+		gamepad_back			= 0x0020,
+		gamepad_left_thumb		= 0x0040,
+		gamepad_right_thumb		= 0x0080,
+		gamepad_left_shoulder	= 0x0100,
+		gamepad_right_shoulder	= 0x0200,
+		gamepad_a				= 0x1000,
+		gamepad_b				= 0x2000,
+		gamepad_x				= 0x4000,
+		gamepad_y				= 0x8000
+	};
+
+	/// gamepad axes in the order they are stored in gamepad_state::axes
+	enum gamepad_axis
+	{
+		gamepad_axis_lthumb_x,
+		gamepad_axis_lthumb_y,
+		gamepad_axis_rthumb_x,
+		gamepad_axis_rthumb_y,
+		gamepad_axis_ltrigger,
+		gamepad_axis_rtrigger,
+		gamepad_axis_count
+	};
+
+	/// raw state of a gamepad. Sticks are in [-32768,32767] and triggers in [0,255].
+	/// axes are padded to 16 bytes so they can be compared in a single vector op.
+	struct gamepad_state
+	{
+		static const int NumAxisSlots = 8;
+
+		core::uint32 buttons;					///< gamepad_button bits
+		core::int16	 axes[NumAxisSlots];		///< indexed by gamepad_axis, unused slots are zero
+	};
+
+	/// difference between two gamepad states
+	struct gamepad_diff
+	{
+		core::uint32 pressed;		///< buttons that went down
+		core::uint32 released;		///< buttons that went up
+		core::uint32 axes;			///< bit per gamepad_axis that changed
+	};
+
+	/// how stick deadzones are applied
+	enum deadzone_mode
+	{
+		/// each axis is clamped and rescaled on its own (square deadzone)
+		deadzone_axial,
+		
+		/// the stick is zeroed while its magnitude is inside the deadzone
+		deadzone_radial,
+		
+		/// as radial, with the magnitude outside the deadzone rescaled to [0,1]
+		deadzone_scaled_radial
+	};
+
+	/// deadzones used when normalising gamepad axes, defaults match XInput's.
+	/// radial modes use the deadzone of a stick's x axis for the whole stick.
+	/// trigger deadzones are the threshold below which the trigger reads zero.
+	struct gamepad_config
+	{
+		deadzone_mode mode;
+		int deadzones[gamepad_axis_count];
+
+		/// \returns the default XInput deadzones
+		static gamepad_config make_default();
+	};
+
+	/// \returns an all zero gamepad state
+	TYCHO_INPUT_ABI gamepad_state make_gamepad_state();
+
+	/// \returns which buttons and axes changed between two states
+	TYCHO_INPUT_ABI gamepad_diff diff_gamepad_state(const gamepad_state& prev, const gamepad_state& cur);
+
+	/// \returns the key a gamepad button bit maps to
+	TYCHO_INPUT_ABI key_type get_gamepad_key(int bit);
+
+	/// \returns the axis a gamepad axis maps to
+	TYCHO_INPUT_ABI axis_type get_gamepad_axis(gamepad_axis a);
+
+	/// \returns the normalised value of a gamepad axis, sticks are in [-1,1] and triggers [0,1]
+	TYCHO_INPUT_ABI float normalise_gamepad_axis(gamepad_axis a, int value, int deadzone);
+
+	/// generate the key and axis events for the change between two states. Only the 
+	/// changed buttons are visited and axes are compared all at once.
+	TYCHO_INPUT_ABI void emit_gamepad_events(int device_id, const gamepad_state& prev, const gamepad_state& cur,
+											 const gamepad_config& config, driver_base::event_handler* handler);
+	
+	/// as above using axis values already normalised with normalise_gamepad_axes
+	/// \param normalised gamepad_axis_count values for cur
+	TYCHO_INPUT_ABI void emit_gamepad_events(int device_id, const gamepad_state& prev, const gamepad_state& cur,
+											 const float* normalised, const gamepad_config& config, 
+											 driver_base::event_handler* handler);
+
+} // end namespace
+} // end namespace
+
+#endif // __GAMEPAD_STATE_H_0B6E3A97_F582_4D1C_A7E4_28C5D91B063F_
@@ -0,0 +1,242 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Monday, 19 October 2026 10:27:44 PM
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input_history.h"
+#include "input/interface.h"
+#include "core/debug/assert.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+namespace tycho
+{
+namespace input
+{
+
+	static_assert(sizeof(tick_input) == tick_input::KeyWords * 3 * 8 + (tick_input::NumAxes + 2) * 2,
+				  "tick_input must not have padding so it can be compared and hashed field by field");
+
+	namespace
+	{
+		/// quantise an axis value in [-1, 1]
+		inline core::int16 quantise_axis(float v)
+		{
+			if(v != v)
+				v = 0.0f;
+			else if(v > 1.0f)
+				v = 1.0f;
+			else if(v < -1.0f)
+				v = -1.0f;
+			float scaled = v * tick_input::AxisScale;
+			return (core::int16)(scaled >= 0 ? scaled + 0.5f : scaled - 0.5f);
+		}
+
+		/// clamp mouse motion to 16 bits
+		inline core::int16 clamp_motion(int v)
+		{
+			return (core::int16)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+		}
+
+		/// fold a 64 bit value into an FNV-1a hash. Whole words rather than bytes, a
+		/// frame is hashed in a handful of multiplies.
+		inline core::uint64 fnv_mix(core::uint64 h, core::uint64 v)
+		{
+			return (h ^ v) * 1099511628211ull;
+		}
+	}
+
+	/// clear everything
+	void tick_input::reset()
+	{
+		core::mem_zero(*this);
+	}
+
+	/// copy the input of a published frame
+	void tick_input::set(const frame_state& state)
+	{
+		for(int i = 0; i < KeyWords; ++i)
+		{
+			down[i] = state.down[i];
+			pressed[i] = state.pressed[i];
+			released[i] = state.released[i];
+		}
+		for(int i = 0; i < NumAxes; ++i)
+			axes[i] = quantise_axis(state.axes[i + 1]);
+		mouse_dx = clamp_motion(state.mouse_dx);
+		mouse_dy = clamp_motion(state.mouse_dy);
+	}
+
+	/// \returns true if the inputs are identical
+	bool tick_input::operator==(const tick_input& other) const
+	{
+		for(int i = 0; i < KeyWords; ++i)
+		{
+			if(down[i] != other.down[i] || pressed[i] != other.pressed[i] || released[i] != other.released[i])
+				return false;
+		}
+		for(int i = 0; i < NumAxes; ++i)
+		{
+			if(axes[i] != other.axes[i])
+				return false;
+		}
+		return mouse_dx == other.mouse_dx && mouse_dy == other.mouse_dy;
+	}
+
+	/// constructor
+	input_history::input_history(int num_groups, int num_ticks) :
+		m_num_groups(num_groups),
+		m_capacity(1),
+		m_mask(0),
+		m_newest(-1),
+		m_count(0)
+	{
+		TYCHO_ASSERT(num_groups > 0 && num_ticks > 0);
+		while(m_capacity < num_ticks)
+			m_capacity *= 2;
+		m_mask = m_capacity - 1;
+		m_frames.resize(m_num_groups * m_capacity);
+		m_hashes.resize(m_capacity, 0);
+		for(size_t i = 0; i < m_frames.size(); ++i)
+			m_frames[i].reset();
+	}
+
+	/// start again, forgetting every stored tick
+	void input_history::reset(int first_tick)
+	{
+		m_newest = first_tick - 1;
+		m_count = 0;
+	}
+
+	/// start the next tick predicting each group holds what it held last tick
+	int input_history::advance()
+	{
+		int tick = begin_tick();
+		rehash(tick & m_mask);
+		return tick;
+	}
+
+	/// start the next tick with the published state of each of the interface's groups,
+	/// groups the interface doesn't have are predicted as advance does.
+	int input_history::snapshot(const interface& ifc)
+	{
+		int tick = begin_tick();
+		int slot = tick & m_mask;
+		int num_groups = ifc.get_num_groups() < m_num_groups ? ifc.get_num_groups() : m_num_groups;
+		for(int g = 0; g < num_groups; ++g)
+			m_frames[g * m_capacity + slot].set(ifc.get_group_state(g));
+		rehash(slot);
+		return tick;
+	}
+
+	/// start the next tick, predicting every group's frame from the previous tick
+	int input_history::begin_tick()
+	{
+		int prev = m_newest & m_mask;
+		int tick = ++m_newest;
+		int slot = tick & m_mask;
+		bool repeat = m_count > 0;
+		if(m_count < m_capacity)
+			++m_count;
+		tick_input* frames = &m_frames[0];
+		for(int g = 0; g < m_num_groups; ++g, frames += m_capacity)
+		{
+			if(repeat)
+				predict(frames[slot], frames[prev]);
+			else
+				frames[slot].reset();
+		}
+		return tick;
+	}
+
+	/// hash every group's frame for a tick
+	void input_history::rehash(int slot)
+	{
+		core::uint64 hash = 0;
+		const tick_input* frames = &m_frames[slot];
+		for(int g = 0; g < m_num_groups; ++g, frames += m_capacity)
+			hash ^= hash_frame(g, *frames);
+		m_hashes[slot] = hash;
+	}
+
+	/// replace the input of a group for a tick, the tick's hash swaps the old frame's
+	/// hash for the new one's so this is O(1) whatever the number of groups.
+	bool input_history::overwrite(int tick, int group, const tick_input& input)
+	{
+		TYCHO_ASSERT(group >= 0 && group < m_num_groups);
+		if(!contains(tick) || group < 0 || group >= m_num_groups)
+			return false;
+		int slot = tick & m_mask;
+		tick_input& f = m_frames[group * m_capacity + slot];
+		m_hashes[slot] ^= hash_frame(group, f) ^ hash_frame(group, input);
+		f = input;
+		return true;
+	}
+
+	/// predict a group's ticks after from_tick again from its input
+	bool input_history::repredict(int from_tick, int group)
+	{
+		TYCHO_ASSERT(group >= 0 && group < m_num_groups);
+		if(!contains(from_tick) || group < 0 || group >= m_num_groups)
+			return false;
+		tick_input* frames = &m_frames[group * m_capacity];
+		for(int tick = from_tick + 1; tick <= m_newest; ++tick)
+		{
+			int slot = tick & m_mask;
+			tick_input& f = frames[slot];
+			core::uint64 old_hash = hash_frame(group, f);
+			predict(f, frames[(tick - 1) & m_mask]);
+			m_hashes[slot] ^= old_hash ^ hash_frame(group, f);
+		}
+		return true;
+	}
+
+	/// predict a frame from the previous tick's
+	void input_history::predict(tick_input& f, const tick_input& prev)
+	{
+		f = prev;
+		for(int i = 0; i < tick_input::KeyWords; ++i)
+		{
+			f.pressed[i] = 0;
+			f.released[i] = 0;
+		}
+		f.mouse_dx = 0;
+		f.mouse_dy = 0;
+	}
+
+	/// \returns hash of a group's frame. FNV-1a over its field values rather than its
+	///			 bytes so it is the same whichever endianness the peer has, finished with
+	///			 a 64 bit mix so that xoring the groups' hashes together stays strong.
+	core::uint64 input_history::hash_frame(int group, const tick_input& f)
+	{
+		core::uint64 h = fnv_mix(14695981039346656037ull, (core::uint64)group);
+		for(int i = 0; i < tick_input::KeyWords; ++i)
+		{
+			h = fnv_mix(h, f.down[i]);
+			h = fnv_mix(h, f.pressed[i]);
+			h = fnv_mix(h, f.released[i]);
+		}
+		core::uint64 v = (core::uint16)f.mouse_dx | (core::uint64)(core::uint16)f.mouse_dy << 16;
+		for(int i = 0; i < tick_input::NumAxes; ++i)
+		{
+			if((i & 3) == 2)
+			{
+				h = fnv_mix(h, v);
+				v = 0;
+			}
+			v |= (core::uint64)(core::uint16)f.axes[i] << ((i + 2) % 4 * 16);
+		}
+		h = fnv_mix(h, v);
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdull;
+		h ^= h >> 33;
+		return h;
+	}
+
+} // end namespace
+} // end namespace
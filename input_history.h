@@ -0,0 +1,177 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Monday, 19 October 2026 10:27:44 PM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __INPUT_HISTORY_H_3D8B51E6_07A4_4C92_B6F3_29E0C7A58D14_
+#define __INPUT_HISTORY_H_3D8B51E6_07A4_4C92_B6F3_29E0C7A58D14_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+#include "input/types.h"
+#include "input/input_state.h"
+#include "core/debug/assert.h"
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+	class interface;
+
+	/// input of a group for a single simulation tick. A compact copy of its frame_state
+	/// with the same queries, axes are quantised to 1 / AxisScale and mouse motion is
+	/// clamped to 16 bits. Has no padding so it can be compared and sent as it is.
+	struct TYCHO_INPUT_ABI tick_input
+	{
+		static const int KeyWords = frame_state::KeyWords;
+		static const int AxisScale = 32767;
+		static const int NumAxes = axis_count - 1;	///< axis_type_invalid isn't stored
+
+		core::uint64 down[KeyWords];		///< keys held at the end of the tick
+		core::uint64 pressed[KeyWords];		///< keys that went down during the tick
+		core::uint64 released[KeyWords];	///< keys that went up during the tick
+		core::int16	 axes[NumAxes];			///< value of each axis, indexed by axis_type - 1
+		core::int16	 mouse_dx;				///< mouse motion over the tick
+		core::int16	 mouse_dy;
+
+		/// \returns true if the key is held
+		bool is_down(key_type k) const { return frame_state::test(down, k); }
+
+		/// \returns true if the key went down during the tick, even if it was also released.
+		bool was_pressed_this_frame(key_type k) const { return frame_state::test(pressed, k); }
+
+		/// \returns true if the key went up during the tick
+		bool was_released_this_frame(key_type k) const { return frame_state::test(released, k); }
+
+		/// \returns the value of an axis
+		float axis_value(axis_type a) const { return axes[a - 1] * (1.0f / AxisScale); }
+
+		/// clear everything
+		void reset();
+
+		/// copy the input of a published frame
+		void set(const frame_state& state);
+
+		/// \returns true if the inputs are identical
+		bool operator==(const tick_input& other) const;
+		bool operator!=(const tick_input& other) const { return !(*this == other); }
+	};
+
+	/// the input of every group for the last N simulation ticks, for rollback. Each tick
+	/// is snapshotted from the interface once its update has run, late input from remote
+	/// players then overwrites the ticks it belongs to, the ticks after it that are still
+	/// predictions are re-predicted, and the game re-simulates from the oldest tick changed,
+	/// reading each tick back with find.
+	///
+	/// Ticks are stored per group, so re-simulating a player reads its frames from
+	/// consecutive memory. A tick's hash is the xor of a hash of each group's frame, it is
+	/// kept up to date as frames are overwritten so peers can compare hashes of confirmed
+	/// ticks to detect a desync. Everything is sized by the constructor, nothing after
+	/// that allocates.
+	class TYCHO_INPUT_ABI input_history
+	{
+	public:
+		/// constructor
+		/// \param num_groups number of groups stored per tick, usually the interface's.
+		/// \param num_ticks number of ticks kept, rounded up to a power of 2.
+		input_history(int num_groups, int num_ticks);
+
+		/// start again, forgetting every stored tick
+		/// \param first_tick number given to the next tick started
+		void reset(int first_tick = 0);
+
+		/// start the next tick, dropping the oldest if the history is full. Its frames
+		/// repeat the previous tick's held keys and axes as a prediction, single tick
+		/// state is cleared.
+		/// \returns the new tick
+		int advance();
+
+		/// start the next tick with the published state of each of the interface's groups
+		/// \returns the new tick
+		int snapshot(const interface& ifc);
+
+		/// \returns the input of a group for a tick, 0 if the tick is no longer or not yet stored
+		const tick_input* find(int tick, int group) const
+		{
+			TYCHO_ASSERT(group >= 0 && group < m_num_groups);
+			return contains(tick) ? &m_frames[group * m_capacity + (tick & m_mask)] : 0;
+		}
+
+		/// replace the input of a group for a tick, e.g. with a late packet from a remote player.
+		/// compare with find first to skip re-simulating when the prediction was right. The
+		/// group's later ticks are left as they are, if they were predicted rather than received
+		/// call repredict once the last received tick has been written.
+		/// \returns false if the tick is no longer or not yet stored
+		bool overwrite(int tick, int group, const tick_input& input);
+
+		/// predict a group's ticks after from_tick up to the newest again from from_tick's
+		/// input, the way advance does, keeping their hashes up to date. Call with the last
+		/// tick received from a remote player after overwriting, or ticks predicted from the
+		/// old input will be re-simulated with it.
+		/// \returns false if from_tick is no longer or not yet stored
+		bool repredict(int from_tick, int group);
+
+		/// \returns hash of every group's input for a tick, 0 if it isn't stored
+		core::uint64 get_hash(int tick) const { return contains(tick) ? m_hashes[tick & m_mask] : 0; }
+
+		/// \returns true if a tick is stored
+		bool contains(int tick) const { return (unsigned)(m_newest - tick) < (unsigned)m_count; }
+
+		/// \returns the most recent tick, only meaningful once a tick has been started
+		int get_newest_tick() const { return m_newest; }
+
+		/// \returns the oldest tick still stored
+		int get_oldest_tick() const { return m_newest - m_count + 1; }
+
+		/// \returns number of ticks stored
+		int get_num_ticks() const { return m_count; }
+
+		/// \returns most ticks that can be stored
+		int get_capacity() const { return m_capacity; }
+
+		/// \returns number of groups stored per tick
+		int get_num_groups() const { return m_num_groups; }
+
+	private:
+		/// non copyable
+		input_history(const input_history&);
+		void operator=(const input_history&);
+
+		/// start the next tick, predicting every group's frame from the previous tick
+		/// \returns the new tick
+		int begin_tick();
+
+		/// hash every group's frame for a tick
+		void rehash(int slot);
+
+		/// predict a frame from the previous tick's, held keys and axes carry on and
+		/// single tick state is cleared
+		static void predict(tick_input& f, const tick_input& prev);
+
+		/// \returns hash of a group's frame
+		static core::uint64 hash_frame(int group, const tick_input& f);
+
+		std::vector<tick_input>		m_frames;		///< m_capacity ticks per group
+		std::vector<core::uint64>	m_hashes;		///< per tick
+		int							m_num_groups;
+		int							m_capacity;
+		int							m_mask;
+		int							m_newest;
+		int							m_count;
+	};
+
+} // end namespace
+} // end namespace
+
+#endif // __INPUT_HISTORY_H_3D8B51E6_07A4_4C92_B6F3_29E0C7A58D14_
@@ -0,0 +1,151 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Saturday, 17 October 2026 04:15:02 PM
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input_recorder.h"
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+namespace tycho
+{
+namespace input
+{
+
+	/// constructor
+	input_recorder::input_recorder() :
+		m_used(0)
+	{
+	}
+	
+	/// destructor, closes the recording
+	input_recorder::~input_recorder()
+	{
+		close();
+	}
+	
+	/// start a new recording
+	bool input_recorder::open(const char* path, const device_description* devices, int num_devices)
+	{
+		close();
+		int capacity = num_devices + recording_header::LateDevices;
+		size_t header_size = sizeof(recording_header) + sizeof(recorded_device) * capacity;
+		size_t size = InitialSize;
+		while(size < header_size)
+			size *= 2;
+		if(!m_file.open_write(path, size))
+			return false;
+		
+		recording_header* header = (recording_header*)m_file.data();
+		header->magic = recording_header::Magic;
+		header->version = recording_header::Version;
+		header->num_devices = num_devices;
+		header->num_events = 0;
+		header->num_initial_devices = num_devices;
+		header->device_capacity = capacity;
+		
+		recorded_device* rd = (recorded_device*)(header + 1);
+		for(int i = 0; i < num_devices; ++i, ++rd)
+			store_device(rd, devices[i]);
+		m_used = header_size;
+		return true;
+	}
+	
+	/// copy a device description into a table entry
+	void input_recorder::store_device(recorded_device* rd, const device_description& desc)
+	{
+		core::mem_zero(*rd);
+		rd->id = desc.id;
+		rd->type = desc.type;
+		rd->index = desc.index;
+		if(desc.name)
+			strncpy(rd->name, desc.name, recorded_device::MaxNameLength - 1);
+	}
+	
+	/// append a device arrival. A device that comes back with the same description
+	/// reuses its table entry so unplugging and replugging doesn't fill the table.
+	void input_recorder::record_device_added(int frame, core::int64 timestamp, const device_description& desc)
+	{
+		TYCHO_ASSERT(is_open());
+		recording_header* header = (recording_header*)m_file.data();
+		recorded_device* table = (recorded_device*)(header + 1);
+		recorded_device entry;
+		store_device(&entry, desc);
+		core::uint32 i = 0;
+		while(i < header->num_devices && memcmp(&table[i], &entry, sizeof(entry)) != 0)
+			++i;
+		if(i == header->num_devices)
+		{
+			if(header->num_devices == header->device_capacity)
+				return;
+			table[header->num_devices++] = entry;
+		}
+		
+		event_packet pkt;
+		pkt.timestamp = timestamp;
+		pkt.index = desc.id;
+		pkt.ptype = packet_type_device_added;
+		pkt.device = make_device_packet(desc);
+		record(frame, pkt);
+	}
+	
+	/// append a device removal
+	void input_recorder::record_device_removed(int frame, core::int64 timestamp, int device_id)
+	{
+		event_packet pkt;
+		pkt.timestamp = timestamp;
+		pkt.index = device_id;
+		pkt.ptype = packet_type_device_removed;
+		pkt.device.type = device_unknown;
+		pkt.device.index = -1;
+		record(frame, pkt);
+	}
+	
+	/// append an event
+	void input_recorder::record(int frame, const event_packet& pkt)
+	{
+		TYCHO_ASSERT(is_open());
+		if(m_used + sizeof(recorded_event) > m_file.size())
+		{
+			if(!m_file.resize(m_file.size() * 2))
+			{
+				// out of disk, stop recording but keep what we have. The file is still
+				// open though unmapped, close trims it to the events already written.
+				close();
+				return;
+			}
+		}
+		recorded_event* e = (recorded_event*)(m_file.data() + m_used);
+		e->frame = frame;
+		e->packet = pkt;
+		m_used += sizeof(recorded_event);
+		++((recording_header*)m_file.data())->num_events;
+	}
+	
+	/// finish the recording, the file is trimmed to the recorded data. Trimming is best
+	/// effort, the file is closed whether it succeeds or not.
+	void input_recorder::close()
+	{
+		if(!m_file.is_open())
+			return;
+		m_file.resize(m_used);
+		m_file.close();
+		m_used = 0;
+	}
+	
+	/// \returns number of events recorded so far
+	core::uint32 input_recorder::get_num_events() const
+	{
+		if(!m_file.is_mapped())
+			return 0;
+		return ((const recording_header*)m_file.data())->num_events;
+	}
+
+} // end namespace
+} // end namespace
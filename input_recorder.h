@@ -0,0 +1,126 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Saturday, 17 October 2026 04:15:02 PM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __INPUT_RECORDER_H_6F0A2D85_B47C_4E19_93D6_C1E58A7B2F04_
+#define __INPUT_RECORDER_H_6F0A2D85_B47C_4E19_93D6_C1E58A7B2F04_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+#include "input/types.h"
+#include "input/mapped_file.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+
+	/// \name recording file format
+	/// a recording is a header, followed by the table of devices, followed by the 
+	/// recorded events in the order they were dispatched. Events are stored exactly as
+	/// they are in memory so a replay can read them straight out of the mapped file.
+	///
+	/// The table starts with the devices that were available when recording started,
+	/// devices that arrive later are appended to it and their arrivals and removals 
+	/// are recorded as device packets. Room for LateDevices is left after the initial
+	/// devices for this, arrivals once it is full aren't recorded.
+	//@{
+	
+	/// recording file header
+	struct recording_header
+	{
+		static const core::uint32 Magic = 0x52495954; // 'TYIR'
+		static const core::uint32 Version = 3;	///< 2 : 64 bit nanosecond timestamps, 3 : device arrivals and removals
+		static const core::uint32 LateDevices = 32;	///< table entries reserved for devices arriving while recording
+
+		core::uint32 magic;
+		core::uint32 version;
+		core::uint32 num_devices;			///< number of recorded_device entries in use
+		core::uint32 num_events;			///< number of recorded_event entries following the device table
+		core::uint32 num_initial_devices;	///< devices available when recording started, the first entries
+		core::uint32 device_capacity;		///< number of recorded_device entries following the header
+	};
+
+	/// device description as stored in a recording
+	struct recorded_device
+	{
+		static const int MaxNameLength = 52;
+
+		core::int32 id;
+		core::int32 type;
+		core::int32 index;
+		char		name[MaxNameLength];	///< always null terminated
+	};
+
+	/// event as stored in a recording
+	struct recorded_event
+	{
+		core::int32  frame;		///< interface::update the event was dispatched in
+		event_packet packet;
+	};
+	//@}
+
+	/// appends every event it is given to a memory mapped recording file. The event
+	/// count in the header is updated as each event is written so a recording that
+	/// is cut short is still readable up to the last event.
+	class TYCHO_INPUT_ABI input_recorder
+	{
+	public:
+		/// constructor
+		input_recorder();
+
+		/// destructor, closes the recording
+		~input_recorder();
+
+		/// start a new recording
+		/// \param devices devices to store in the recording, these are replayed with the same ids.
+		bool open(const char* path, const device_description* devices, int num_devices);
+
+		/// append an event
+		void record(int frame, const event_packet& pkt);
+
+		/// append a device arrival, adding the device to the table if it isn't already
+		void record_device_added(int frame, core::int64 timestamp, const device_description& desc);
+
+		/// append a device removal
+		void record_device_removed(int frame, core::int64 timestamp, int device_id);
+
+		/// finish the recording, the file is trimmed to the recorded data.
+		/// Also called when growing the file fails, what was recorded is kept.
+		void close();
+
+		/// \returns true if recording
+		bool is_open() const { return m_file.is_open(); }
+
+		/// \returns number of events recorded so far
+		core::uint32 get_num_events() const;
+
+	private:
+		/// non copyable
+		input_recorder(const input_recorder&);
+		void operator=(const input_recorder&);
+
+		static const size_t InitialSize = 1 << 20;
+
+		/// copy a device description into a table entry
+		static void store_device(recorded_device* rd, const device_description& desc);
+
+		mapped_file m_file;
+		size_t		m_used;		///< bytes written so far
+	};
+
+} // end namespace
+} // end namespace
+
+#endif // __INPUT_RECORDER_H_6F0A2D85_B47C_4E19_93D6_C1E58A7B2F04_
@@ -0,0 +1,99 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Sunday, 18 October 2026 11:04:51 AM
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input_state.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+namespace tycho
+{
+namespace input
+{
+
+	/// clear everything
+	void frame_state::reset()
+	{
+		core::mem_zero(*this);
+	}
+	
+	/// clear the state that only applies to a single frame
+	void frame_state::reset_frame()
+	{
+		for(int i = 0; i < KeyWords; ++i)
+		{
+			pressed[i] = 0;
+			released[i] = 0;
+		}
+		mouse_dx = 0;
+		mouse_dy = 0;
+	}
+	
+	/// \returns true if any single frame state is set
+	bool frame_state::has_frame_state() const
+	{
+		core::uint64 any = 0;
+		for(int i = 0; i < KeyWords; ++i)
+			any |= pressed[i] | released[i];
+		return any || mouse_dx || mouse_dy;
+	}
+	
+	/// constructor
+	input_state::input_state() :
+		m_queued(false)
+	{
+		m_live.reset();
+		m_published.reset();
+	}
+	
+	/// apply an event to the live state
+	void input_state::apply(const event_packet& pkt)
+	{
+		switch(pkt.ptype)
+		{
+			case packet_type_keyboard:
+			{
+				int k = pkt.keyboard.key;
+				if(k <= key_invalid || k >= key_count)
+					break;
+				if(pkt.keyboard.state == key_state_down)
+				{
+					frame_state::set(m_live.down, k);
+					frame_state::set(m_live.pressed, k);
+				}
+				else if(pkt.keyboard.state == key_state_up)
+				{
+					frame_state::clear(m_live.down, k);
+					frame_state::set(m_live.released, k);
+				}
+				break;
+			}
+			case packet_type_mouse:
+				m_live.mouse_dx += pkt.mouse.dx;
+				m_live.mouse_dy += pkt.mouse.dy;
+				break;
+			case packet_type_axis:
+				if(pkt.axis.axis > axis_type_invalid && pkt.axis.axis < axis_count)
+					m_live.axes[pkt.axis.axis] = pkt.axis.value;
+				break;
+			default:
+				break;
+		}
+	}
+	
+	/// publish the live state and clear its single frame state.
+	bool input_state::publish()
+	{
+		m_published = m_live;
+		m_live.reset_frame();
+		return m_published.has_frame_state();
+	}
+
+} // end namespace
+} // end namespace
@@ -0,0 +1,104 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Sunday, 18 October 2026 11:04:51 AM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __INPUT_STATE_H_4E7A9C03_2B61_4D8F_95E2_D0B3F6A81C7E_
+#define __INPUT_STATE_H_4E7A9C03_2B61_4D8F_95E2_D0B3F6A81C7E_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+#include "input/types.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+
+	/// snapshot of the state of a device or device group at the end of an update.
+	/// all queries are O(1) and read only.
+	struct TYCHO_INPUT_ABI frame_state
+	{
+		static const int KeyWords = (key_count + 63) / 64;
+
+		core::uint64 down[KeyWords];		///< keys currently held
+		core::uint64 pressed[KeyWords];		///< keys that went down during the frame
+		core::uint64 released[KeyWords];	///< keys that went up during the frame
+		float		 axes[axis_count];		///< last value of each axis
+		int			 mouse_dx;				///< mouse motion accumulated over the frame
+		int			 mouse_dy;
+
+		/// \returns true if the key is held
+		bool is_down(key_type k) const { return test(down, k); }
+
+		/// \returns true if the key went down during the last update, even if it was also released.
+		bool was_pressed_this_frame(key_type k) const { return test(pressed, k); }
+
+		/// \returns true if the key went up during the last update
+		bool was_released_this_frame(key_type k) const { return test(released, k); }
+
+		/// \returns the last value of an axis
+		float axis_value(axis_type a) const { return axes[a]; }
+
+		/// clear everything
+		void reset();
+
+		/// clear the state that only applies to a single frame
+		void reset_frame();
+
+		/// \returns true if any single frame state is set
+		bool has_frame_state() const;
+
+		static bool test(const core::uint64* bits, int i)
+			{ return ((bits[i >> 6] >> (i & 63)) & 1) != 0; }
+		static void set(core::uint64* bits, int i)
+			{ bits[i >> 6] |= (core::uint64)1 << (i & 63); }
+		static void clear(core::uint64* bits, int i)
+			{ bits[i >> 6] &= ~((core::uint64)1 << (i & 63)); }
+	};
+
+	/// double buffered input state. Events are applied to a live copy during 
+	/// interface::update which is published at the end of the update, queries 
+	/// always see the published copy so they are consistent for the whole frame.
+	class TYCHO_INPUT_ABI input_state
+	{
+	public:
+		/// constructor
+		input_state();
+
+		/// apply an event to the live state
+		void apply(const event_packet& pkt);
+
+		/// publish the live state and clear its single frame state.
+		/// \returns true if the published state has single frame state, it must then be
+		///			 published again next frame to clear it.
+		bool publish();
+
+		/// \returns the published state
+		const frame_state& get() const { return m_published; }
+
+		/// \returns true if the key is held in the live state, i.e. as of the last event applied
+		bool is_held(int k) const { return frame_state::test(m_live.down, k); }
+
+		/// true while the state is queued for publishing, managed by the owner.
+		bool m_queued;
+
+	private:
+		frame_state m_live;
+		frame_state m_published;
+	};
+
+} // end namespace
+} // end namespace
+
+#endif // __INPUT_STATE_H_4E7A9C03_2B61_4D8F_95E2_D0B3F6A81C7E_
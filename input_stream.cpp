@@ -0,0 +1,640 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Monday, 19 October 2026 04:12:38 PM
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input_stream.h"
+#include "input/timestamp.h"
+#include "input/intrinsics.h"
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+namespace tycho
+{
+namespace input
+{
+
+	namespace detail
+	{
+		/// size of the stream header, the resolution varint is at most this long too
+		const size_t StreamHeaderSize = 5;
+		const size_t MaxVarintSize = 10;
+
+		/// map signed values to unsigned so small magnitudes of either sign stay small
+		inline core::uint64 zigzag(core::int64 v)
+		{
+			return ((core::uint64)v << 1) ^ (core::uint64)(v >> 63);
+		}
+
+		/// inverse of zigzag
+		inline core::int64 unzigzag(core::uint64 v)
+		{
+			return (core::int64)(v >> 1) ^ -(core::int64)(v & 1);
+		}
+
+		/// write a varint, there must be room for MaxVarintSize bytes
+		inline core::uint8* write_varint(core::uint8* p, core::uint64 v)
+		{
+			while(v >= 0x80)
+			{
+				*p++ = (core::uint8)(v | 0x80);
+				v >>= 7;
+			}
+			*p++ = (core::uint8)v;
+			return p;
+		}
+
+		/// read a varint
+		/// \param Checked false if the caller has made sure there are MaxVarintSize bytes
+		/// \returns the end of the varint or 0 if it runs past end or is too long
+		template<bool Checked> inline const core::uint8* read_varint(const core::uint8* p, const core::uint8* end, core::uint64& v)
+		{
+			// nearly everything is a single byte
+			if((!Checked || p != end) && *p < 0x80)
+			{
+				v = *p;
+				return p + 1;
+			}
+			v = 0;
+			for(int shift = 0; (!Checked || p != end) && shift < 64; shift += 7)
+			{
+				core::uint8 b = *p++;
+				v |= (core::uint64)(b & 0x7f) << shift;
+				if(b < 0x80)
+					return p;
+			}
+			return 0;
+		}
+
+		/// quantise an axis value in [-1, 1]
+		inline core::int16 quantise_axis(float v)
+		{
+			if(v != v)
+				v = 0.0f;
+			else if(v > 1.0f)
+				v = 1.0f;
+			else if(v < -1.0f)
+				v = -1.0f;
+			float scaled = v * stream_format::AxisScale;
+			return (core::int16)(scaled >= 0 ? scaled + 0.5f : scaled - 0.5f);
+		}
+
+		/// records are decoded without bounds checks while at least this many bytes
+		/// remain, enough for every field before a device name at its longest
+		const ptrdiff_t UncheckedSize = 64;
+
+		/// delta state of a stream being decoded
+		struct record_state
+		{
+			int			device;
+			core::int64	ticks;
+			int			resolution;
+			bool*		error;
+		};
+
+		/// decode a single record, the state is only changed if the whole record is available.
+		/// Keys, key states, axes and device types out of range would index past the end of
+		/// the interface's tables so they make the stream invalid like an unknown kind does.
+		/// \param Checked false if there are at least UncheckedSize bytes left
+		/// \returns the end of the record or 0 if it is incomplete or invalid
+		template<bool Checked> TYCHO_INPUT_FORCEINLINE const core::uint8* decode_record(const core::uint8* p, const core::uint8* end, 
+			record_state& s, event_packet& pkt, const char** name, int* name_length)
+		{
+			if(Checked && p == end)
+				return 0;
+			core::uint8 tag = *p++;
+			int payload = tag >> stream_format::PayloadShift;
+			core::uint64 v;
+			int device = s.device;
+			if(!(tag & stream_format::SameDevice))
+			{
+				if(!(p = read_varint<Checked>(p, end, v)))
+					return 0;
+				device += (int)unzigzag(v);
+			}
+			core::int64 ticks = s.ticks;
+			if(!(tag & stream_format::SameTime))
+			{
+				if(!(p = read_varint<Checked>(p, end, v)))
+					return 0;
+				ticks += unzigzag(v);
+			}
+
+			switch(tag & stream_format::KindMask)
+			{
+				case stream_format::kind_key:
+					if(Checked && p == end)
+						return 0;
+					if(*p <= key_invalid || *p >= key_count || (payload & 3) <= key_state_invalid || (payload & 3) >= key_state_count)
+					{
+						*s.error = true;
+						return 0;
+					}
+					pkt.ptype = packet_type_keyboard;
+					pkt.keyboard.state = (key_state)(payload & 3);
+					pkt.keyboard.key = (key_type)*p++;
+					break;
+				case stream_format::kind_mouse:
+					pkt.ptype = packet_type_mouse;
+					pkt.mouse.dx = 0;
+					pkt.mouse.dy = 0;
+					if(payload & 1)
+					{
+						if(!(p = read_varint<Checked>(p, end, v)))
+							return 0;
+						pkt.mouse.dx = (int)unzigzag(v);
+					}
+					if(payload & 2)
+					{
+						if(!(p = read_varint<Checked>(p, end, v)))
+							return 0;
+						pkt.mouse.dy = (int)unzigzag(v);
+					}
+					break;
+				case stream_format::kind_axis:
+					if(Checked && end - p < 2)
+						return 0;
+					if(payload <= axis_type_invalid || payload >= axis_count)
+					{
+						*s.error = true;
+						return 0;
+					}
+					pkt.ptype = packet_type_axis;
+					pkt.axis.axis = (axis_type)payload;
+					pkt.axis.value = (float)(core::int16)(p[0] | (p[1] << 8)) / stream_format::AxisScale;
+					p += 2;
+					break;
+				case stream_format::kind_device_added:
+					if(Checked && p == end)
+						return 0;
+					if(*p >= device_count)
+					{
+						*s.error = true;
+						return 0;
+					}
+					pkt.ptype = packet_type_device_added;
+					pkt.device.type = (device_type)*p++;
+					if(!(p = read_varint<Checked>(p, end, v)))
+						return 0;
+					pkt.device.index = (int)unzigzag(v);
+					if(!(p = read_varint<Checked>(p, end, v)) || v > (core::uint64)(end - p))
+						return 0;
+					*name = (const char*)p;
+					*name_length = (int)v;
+					p += v;
+					break;
+				case stream_format::kind_device_removed:
+					pkt.ptype = packet_type_device_removed;
+					pkt.device.type = device_unknown;
+					pkt.device.index = -1;
+					break;
+				default:
+					*s.error = true;
+					return 0;
+			}
+			pkt.index = device;
+			pkt.timestamp = ticks * s.resolution;
+			s.device = device;
+			s.ticks = ticks;
+			return p;
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////////
+	// stream_encoder
+	//////////////////////////////////////////////////////////////////////////////
+
+	/// constructor, the stream header is written immediately
+	stream_encoder::stream_encoder(int resolution_ns) :
+		m_size(0),
+		m_resolution(resolution_ns > 0 ? resolution_ns : 1),
+		m_last_device(0),
+		m_last_ticks(0),
+		m_num_events(0)
+	{
+		reset();
+	}
+
+	void stream_encoder::handle_mouse_event(int device_id, const mouse_packet& mouse)
+	{
+		event_packet pkt;
+		pkt.timestamp = get_timestamp();
+		pkt.index = device_id;
+		pkt.ptype = packet_type_mouse;
+		pkt.mouse = mouse;
+		encode(pkt);
+	}
+
+	void stream_encoder::handle_keyboard_event(int device_id, const keyboard_packet& keyboard)
+	{
+		event_packet pkt;
+		pkt.timestamp = get_timestamp();
+		pkt.index = device_id;
+		pkt.ptype = packet_type_keyboard;
+		pkt.keyboard = keyboard;
+		encode(pkt);
+	}
+
+	void stream_encoder::handle_axis_event(int device_id, const axis_packet& axis)
+	{
+		event_packet pkt;
+		pkt.timestamp = get_timestamp();
+		pkt.index = device_id;
+		pkt.ptype = packet_type_axis;
+		pkt.axis = axis;
+		encode(pkt);
+	}
+
+	void stream_encoder::handle_device_added(const device_description& desc)
+	{
+		encode_device_added(desc, get_timestamp());
+	}
+
+	void stream_encoder::handle_device_removed(int device_id)
+	{
+		end_record(begin_record(stream_format::kind_device_removed, 0, device_id, get_timestamp(), stream_format::MaxRecordSize));
+	}
+
+	/// encode a packet keeping its timestamp
+	void stream_encoder::encode(const event_packet& pkt)
+	{
+		core::uint8* p;
+		switch(pkt.ptype)
+		{
+			case packet_type_keyboard:
+				p = begin_record(stream_format::kind_key, pkt.keyboard.state, pkt.index, pkt.timestamp, stream_format::MaxRecordSize);
+				*p++ = (core::uint8)pkt.keyboard.key;
+				end_record(p);
+				break;
+			case packet_type_mouse:
+				p = begin_record(stream_format::kind_mouse, (pkt.mouse.dx ? 1 : 0) | (pkt.mouse.dy ? 2 : 0), pkt.index, pkt.timestamp, stream_format::MaxRecordSize);
+				if(pkt.mouse.dx)
+					p = detail::write_varint(p, detail::zigzag(pkt.mouse.dx));
+				if(pkt.mouse.dy)
+					p = detail::write_varint(p, detail::zigzag(pkt.mouse.dy));
+				end_record(p);
+				break;
+			case packet_type_axis:
+			{
+				p = begin_record(stream_format::kind_axis, pkt.axis.axis, pkt.index, pkt.timestamp, stream_format::MaxRecordSize);
+				core::uint16 q = (core::uint16)detail::quantise_axis(pkt.axis.value);
+				p[0] = (core::uint8)q;
+				p[1] = (core::uint8)(q >> 8);
+				end_record(p + 2);
+				break;
+			}
+			case packet_type_device_added:
+			{
+				device_description desc = { pkt.index, pkt.device.type, 0, pkt.device.index };
+				encode_device_added(desc, pkt.timestamp);
+				break;
+			}
+			case packet_type_device_removed:
+				end_record(begin_record(stream_format::kind_device_removed, 0, pkt.index, pkt.timestamp, stream_format::MaxRecordSize));
+				break;
+			default:
+				break;
+		}
+	}
+
+	/// start a new stream
+	void stream_encoder::reset()
+	{
+		m_size = 0;
+		m_last_device = 0;
+		m_last_ticks = 0;
+		m_num_events = 0;
+		core::uint8* p = reserve(detail::StreamHeaderSize + detail::MaxVarintSize);
+		p[0] = (core::uint8)stream_format::Magic;
+		p[1] = (core::uint8)(stream_format::Magic >> 8);
+		p[2] = (core::uint8)(stream_format::Magic >> 16);
+		p[3] = (core::uint8)(stream_format::Magic >> 24);
+		p[4] = stream_format::Version;
+		p = detail::write_varint(p + detail::StreamHeaderSize, (core::uint64)m_resolution);
+		m_size = p - &m_data[0];
+	}
+
+	/// make room for a record of up to size bytes
+	core::uint8* stream_encoder::reserve(size_t size)
+	{
+		if(m_size + size > m_data.size())
+		{
+			size_t capacity = m_data.empty() ? 4096 : m_data.size() * 2;
+			while(capacity < m_size + size)
+				capacity *= 2;
+			m_data.resize(capacity);
+		}
+		return &m_data[m_size];
+	}
+
+	/// write the tag, device and tick deltas of a record
+	core::uint8* stream_encoder::begin_record(int kind, int payload, int device_id, core::int64 timestamp, size_t max_size)
+	{
+		core::uint8* p = reserve(max_size);
+		core::uint8* tag = p++;
+		core::uint8 t = (core::uint8)(kind | (payload << stream_format::PayloadShift));
+		if(device_id == m_last_device)
+			t |= stream_format::SameDevice;
+		else
+		{
+			p = detail::write_varint(p, detail::zigzag((core::int64)device_id - m_last_device));
+			m_last_device = device_id;
+		}
+		core::int64 ticks = timestamp / m_resolution;
+		if(ticks == m_last_ticks)
+			t |= stream_format::SameTime;
+		else
+		{
+			p = detail::write_varint(p, detail::zigzag(ticks - m_last_ticks));
+			m_last_ticks = ticks;
+		}
+		*tag = t;
+		return p;
+	}
+
+	/// finish a record ending at p
+	void stream_encoder::end_record(core::uint8* p)
+	{
+		m_size = p - &m_data[0];
+		++m_num_events;
+	}
+
+	/// encode a device arrival
+	void stream_encoder::encode_device_added(const device_description& desc, core::int64 timestamp)
+	{
+		size_t length = desc.name ? strlen(desc.name) : 0;
+		if(length > (size_t)stream_format::MaxNameLength)
+			length = stream_format::MaxNameLength;
+		core::uint8* p = begin_record(stream_format::kind_device_added, 0, desc.id, timestamp,
+									  stream_format::MaxRecordSize + 1 + 2 * detail::MaxVarintSize + length);
+		*p++ = (core::uint8)desc.type;
+		p = detail::write_varint(p, detail::zigzag(desc.index));
+		p = detail::write_varint(p, length);
+		if(length)
+			memcpy(p, desc.name, length);
+		end_record(p + length);
+	}
+
+	//////////////////////////////////////////////////////////////////////////////
+	// stream_decoder
+	//////////////////////////////////////////////////////////////////////////////
+
+	/// constructor
+	stream_decoder::stream_decoder() :
+		m_size(0),
+		m_read(0),
+		m_have_header(false),
+		m_error(false),
+		m_resolution(1),
+		m_last_device(0),
+		m_last_ticks(0),
+		m_driver_id(0),
+		m_cur(0),
+		m_cur_remote(-1)
+	{
+	}
+
+	/// destructor
+	stream_decoder::~stream_decoder()
+	{
+		for(size_t i = 0; i < m_devices.size(); ++i)
+			delete m_devices[i];
+		for(size_t i = 0; i < m_free.size(); ++i)
+			delete m_free[i];
+	}
+
+	/// append received bytes
+	void stream_decoder::feed(const void* data, size_t size)
+	{
+		if(!size)
+			return;
+		// move the undecoded tail of the last feed to the front
+		if(m_read)
+		{
+			memmove(&m_data[0], &m_data[0] + m_read, m_size - m_read);
+			m_size -= m_read;
+			m_read = 0;
+		}
+		if(m_size + size > m_data.size())
+		{
+			size_t capacity = m_data.empty() ? 4096 : m_data.size() * 2;
+			while(capacity < m_size + size)
+				capacity *= 2;
+			m_data.resize(capacity);
+		}
+		memcpy(&m_data[m_size], data, size);
+		m_size += size;
+	}
+
+	/// decode complete records into packets
+	int stream_decoder::decode(event_packet* out, int max_packets)
+	{
+		if(!read_header())
+			return 0;
+		const core::uint8* p = &m_data[0] + m_read;
+		const core::uint8* end = &m_data[0] + m_size;
+		detail::record_state state = { m_last_device, m_last_ticks, m_resolution, &m_error };
+		const char* name = 0;
+		int name_length = 0;
+		int n = 0;
+		while(n < max_packets && end - p >= detail::UncheckedSize)
+		{
+			const core::uint8* next = detail::decode_record<false>(p, end, state, out[n], &name, &name_length);
+			if(!next)
+				break;
+			p = next;
+			++n;
+		}
+		while(n < max_packets)
+		{
+			const core::uint8* next = detail::decode_record<true>(p, end, state, out[n], &name, &name_length);
+			if(!next)
+				break;
+			p = next;
+			++n;
+		}
+		m_last_device = state.device;
+		m_last_ticks = state.ticks;
+		m_read = p - &m_data[0];
+		return n;
+	}
+
+	bool stream_decoder::initialise(int driver_id)
+	{
+		m_driver_id = driver_id;
+		return true;
+	}
+
+	/// issue every complete record to the handler
+	void stream_decoder::update(event_handler* handler)
+	{
+		if(!read_header())
+			return;
+		const core::uint8* p = &m_data[0] + m_read;
+		const core::uint8* end = &m_data[0] + m_size;
+		detail::record_state state = { m_last_device, m_last_ticks, m_resolution, &m_error };
+		event_packet pkt;
+		const char* name = 0;
+		int name_length = 0;
+		while(end - p >= detail::UncheckedSize)
+		{
+			const core::uint8* next = detail::decode_record<false>(p, end, state, pkt, &name, &name_length);
+			if(!next)
+				break;
+			p = next;
+			issue(handler, pkt, name, name_length);
+		}
+		while(const core::uint8* next = detail::decode_record<true>(p, end, state, pkt, &name, &name_length))
+		{
+			p = next;
+			issue(handler, pkt, name, name_length);
+		}
+		m_last_device = state.device;
+		m_last_ticks = state.ticks;
+		m_read = p - &m_data[0];
+	}
+
+	/// issue a decoded record with its device mapped to our id
+	void stream_decoder::issue(event_handler* handler, const event_packet& pkt, const char* name, int name_length)
+	{
+		if(pkt.ptype == packet_type_device_added)
+		{
+			m_cur = add_remote(pkt, name, name_length);
+			m_cur_remote = pkt.index;
+			handler->handle_device_added(m_cur->desc);
+			return;
+		}
+		if(pkt.index != m_cur_remote)
+		{
+			m_cur = find_remote(pkt.index);
+			m_cur_remote = pkt.index;
+		}
+
+		// events from devices we weren't told about can't be routed
+		if(!m_cur)
+			return;
+		int device_id = m_cur->desc.id;
+		switch(pkt.ptype)
+		{
+			case packet_type_keyboard: handler->handle_keyboard_event(device_id, pkt.keyboard); break;
+			case packet_type_mouse: handler->handle_mouse_event(device_id, pkt.mouse); break;
+			case packet_type_axis: handler->handle_axis_event(device_id, pkt.axis); break;
+			case packet_type_device_removed:
+				handler->handle_device_removed(device_id);
+				for(size_t i = 0; i < m_devices.size(); ++i)
+				{
+					if(m_devices[i] == m_cur)
+					{
+						m_devices.erase(m_devices.begin() + i);
+						break;
+					}
+				}
+				m_free.push_back(m_cur);
+				m_cur = 0;
+				break;
+			default: break;
+		}
+	}
+
+	/// start decoding a new stream
+	void stream_decoder::reset()
+	{
+		m_size = 0;
+		m_read = 0;
+		m_have_header = false;
+		m_error = false;
+		m_resolution = 1;
+		m_last_device = 0;
+		m_last_ticks = 0;
+		m_cur = 0;
+		m_cur_remote = -1;
+	}
+
+	/// read the stream header if it hasn't been yet
+	bool stream_decoder::read_header()
+	{
+		if(m_have_header)
+			return true;
+		if(m_error || m_size - m_read < detail::StreamHeaderSize + 1)
+			return false;
+		const core::uint8* p = &m_data[0] + m_read;
+		core::uint32 magic = p[0] | (p[1] << 8) | (p[2] << 16) | ((core::uint32)p[3] << 24);
+		if(magic != stream_format::Magic || p[4] != stream_format::Version)
+		{
+			m_error = true;
+			return false;
+		}
+		core::uint64 resolution;
+		const core::uint8* end = detail::read_varint<true>(p + detail::StreamHeaderSize, &m_data[0] + m_size, resolution);
+		if(!end)
+			return false;
+		if(resolution == 0 || resolution > 0x7fffffff)
+		{
+			m_error = true;
+			return false;
+		}
+		m_resolution = (int)resolution;
+		m_read = end - &m_data[0];
+		m_have_header = true;
+		return true;
+	}
+
+	/// \returns the device with a remote id or 0
+	stream_decoder::remote_device* stream_decoder::find_remote(int remote_id) const
+	{
+		for(size_t i = 0; i < m_devices.size(); ++i)
+		{
+			if(m_devices[i]->remote_id == remote_id)
+				return m_devices[i];
+		}
+		return 0;
+	}
+
+	/// add a device seen in the stream, it is given the lowest device number not in use
+	stream_decoder::remote_device* stream_decoder::add_remote(const event_packet& pkt, const char* name, int name_length)
+	{
+		remote_device* d = find_remote(pkt.index);
+		if(!d)
+		{
+			int num = 0;
+			for(size_t i = 0; i < m_devices.size(); )
+			{
+				int driver_id, device_num;
+				split_device_id(m_devices[i]->desc.id, &driver_id, &device_num);
+				if(device_num == num)
+				{
+					++num;
+					i = 0;
+				}
+				else
+					++i;
+			}
+			if(m_free.empty())
+				d = new remote_device;
+			else
+			{
+				d = m_free.back();
+				m_free.pop_back();
+			}
+			d->remote_id = pkt.index;
+			d->desc.id = make_device_id(m_driver_id, num);
+			m_devices.push_back(d);
+		}
+		if(name_length > stream_format::MaxNameLength)
+			name_length = stream_format::MaxNameLength;
+		memcpy(d->name, name, name_length);
+		d->name[name_length] = 0;
+		d->desc.type = pkt.device.type;
+		d->desc.index = pkt.device.index;
+		d->desc.name = d->name;
+		return d;
+	}
+
+} // end namespace
+} // end namespace
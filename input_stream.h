@@ -0,0 +1,243 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Monday, 19 October 2026 04:12:38 PM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __INPUT_STREAM_H_5B93E0C7_1A64_4F2D_8C3B_E7049D2A61F8_
+#define __INPUT_STREAM_H_5B93E0C7_1A64_4F2D_8C3B_E7049D2A61F8_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+#include "input/driver_base.h"
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+
+	/// \name input stream format
+	/// compact byte stream of input events for sending between processes and for
+	/// long recordings. A stream is a header followed by records, all multi byte
+	/// values are little endian and varints are 7 bits per byte, least significant
+	/// group first. Signed values are zigzag coded before being written as varints.
+	///
+	/// header : uint32 magic, uint8 version, varint timestamp resolution in nanoseconds
+	///
+	/// record : uint8 tag, [varint device delta], [varint tick delta], payload
+	/// - tag bits 0-2 are the record kind, bits 5-7 are kind specific.
+	/// - the device delta is left out when the tag has SameDevice set, otherwise
+	///   it is the difference from the previous record's device id.
+	/// - the tick delta is left out when the tag has SameTime set, otherwise it is
+	///   the difference in timestamp / resolution from the previous record.
+	///
+	/// payloads by kind
+	/// - key : tag bits 5-6 are the key_state, followed by a uint8 key_type
+	/// - mouse : tag bit 5 / 6 set if dx / dy follow as signed varints, absent deltas are 0
+	/// - axis : tag bits 5-7 are the axis_type, followed by the value as an int16
+	///   scaled by AxisScale
+	/// - device added : uint8 device_type, varint index, varint name length, name bytes
+	/// - device removed : nothing
+	//@{
+	struct stream_format
+	{
+		static const core::uint32 Magic = 0x53495954;	// 'TYIS'
+		static const core::uint8 Version = 1;
+
+		/// record kinds
+		enum kind
+		{
+			kind_key,
+			kind_mouse,
+			kind_axis,
+			kind_device_added,
+			kind_device_removed,
+			kind_count
+		};
+
+		static const core::uint8 KindMask = 0x07;
+		static const core::uint8 SameDevice = 0x08;
+		static const core::uint8 SameTime = 0x10;
+		static const int PayloadShift = 5;
+
+		static const int AxisScale = 32767;		///< axis values are quantised to 1 / AxisScale
+		static const int MaxNameLength = 63;	///< longer device names are truncated
+
+		/// largest record other than device added
+		static const int MaxRecordSize = 32;
+	};
+	//@}
+
+	static_assert(axis_count <= 8 && key_state_count <= 4, "axis and key state must fit in the record tag");
+
+	/// encodes events into the input stream format. As an event handler it can be
+	/// passed to a driver's update directly, events are stamped with get_timestamp
+	/// as they arrive the same way event_ring does. The encoded bytes are kept
+	/// until the owner has sent or written them and calls clear.
+	///
+	/// A receiver only knows about devices it has seen added, to stream from devices
+	/// that are already connected call handle_device_added for each of them first.
+	class TYCHO_INPUT_ABI stream_encoder : public driver_base::event_handler
+	{
+	public:
+		static const int DefaultResolution = 1000;	///< microsecond timestamps
+
+		/// constructor, the stream header is written immediately.
+		/// \param resolution_ns timestamps are stored in multiples of this, 1 keeps them exact.
+		explicit stream_encoder(int resolution_ns = DefaultResolution);
+
+		/// \name driver_base::event_handler interface
+		//@{
+		virtual void handle_mouse_event(int device_id, const mouse_packet&);
+		virtual void handle_keyboard_event(int device_id, const keyboard_packet&);
+		virtual void handle_axis_event(int device_id, const axis_packet&);
+		virtual void handle_device_added(const device_description& desc);
+		virtual void handle_device_removed(int device_id);
+		//@}
+
+		/// encode a packet keeping its timestamp, e.g. when converting a recording.
+		/// device added packets don't carry a name so it is left empty.
+		void encode(const event_packet& pkt);
+
+		/// \returns the encoded bytes not yet cleared
+		const core::uint8* get_data() const { return m_data.empty() ? 0 : &m_data[0]; }
+
+		/// \returns the number of encoded bytes not yet cleared
+		size_t get_size() const { return m_size; }
+
+		/// drop the encoded bytes once they have been sent, the stream continues
+		/// from where it was so the receiver must have been given everything so far.
+		void clear() { m_size = 0; }
+
+		/// start a new stream, e.g. for a new connection. Encoded bytes are dropped
+		/// and a new header is written.
+		void reset();
+
+		/// \returns number of events encoded since the stream started
+		core::uint64 get_num_events() const { return m_num_events; }
+
+	private:
+		/// non copyable
+		stream_encoder(const stream_encoder&);
+		void operator=(const stream_encoder&);
+
+		/// make room for a record of up to size bytes
+		core::uint8* reserve(size_t size);
+
+		/// write the tag, device and tick deltas of a record
+		/// \returns position of the payload
+		core::uint8* begin_record(int kind, int payload, int device_id, core::int64 timestamp, size_t max_size);
+
+		/// finish a record ending at p
+		void end_record(core::uint8* p);
+
+		/// encode a device arrival
+		void encode_device_added(const device_description& desc, core::int64 timestamp);
+
+		std::vector<core::uint8> m_data;
+		size_t		 m_size;
+		int			 m_resolution;
+		int			 m_last_device;
+		core::int64	 m_last_ticks;
+		core::uint64 m_num_events;
+	};
+
+	/// decodes the input stream format. Bytes are fed in as they are received, in
+	/// any sized pieces, and complete records are decoded either into packets with
+	/// decode, or as a driver issuing them to the interface from update. Use one or
+	/// the other on a decoder, not both.
+	///
+	/// As a driver the devices added in the stream are given ids of its own so they
+	/// can be used alongside local devices. feed and update must be called from the
+	/// same thread, which is the capture thread if one is running.
+	class TYCHO_INPUT_ABI stream_decoder : public driver_base
+	{
+	public:
+		/// constructor
+		stream_decoder();
+
+		/// destructor
+		virtual ~stream_decoder();
+
+		/// append received bytes
+		void feed(const void* data, size_t size);
+
+		/// decode complete records into packets. Device ids are the ones in the
+		/// stream and device added packets have their names dropped.
+		/// \returns number of packets written to out
+		int decode(event_packet* out, int max_packets);
+
+		/// \name driver_base interface
+		//@{
+		virtual bool initialise(int driver_id);
+		virtual void update(event_handler *);
+		virtual int get_num_devices() const { return (int)m_devices.size(); }
+		virtual const device_description* get_device_desc(int i) const { return &m_devices[i]->desc; }
+		//@}
+
+		/// start decoding a new stream, buffered bytes are dropped. Devices stay
+		/// connected, the new stream is expected to add them again.
+		void reset();
+
+		/// \returns false if the stream is not in the input stream format or had a record
+		///			 with a value out of range, nothing more is decoded until it is reset.
+		bool is_valid() const { return !m_error; }
+
+		/// \returns number of bytes fed but not yet decoded
+		size_t get_pending() const { return m_size - m_read; }
+
+	private:
+		/// non copyable
+		stream_decoder(const stream_decoder&);
+		void operator=(const stream_decoder&);
+
+		/// device added in the stream
+		struct remote_device
+		{
+			int					remote_id;
+			device_description	desc;
+			char				name[stream_format::MaxNameLength + 1];
+		};
+
+		/// read the stream header if it hasn't been yet
+		/// \returns true once the header has been read
+		bool read_header();
+
+		/// issue a decoded record with its device mapped to our id
+		void issue(event_handler* handler, const event_packet& pkt, const char* name, int name_length);
+
+		/// \returns the device with a remote id or 0
+		remote_device* find_remote(int remote_id) const;
+
+		/// add a device seen in the stream
+		remote_device* add_remote(const event_packet& pkt, const char* name, int name_length);
+
+		std::vector<core::uint8>	m_data;
+		size_t						m_size;
+		size_t						m_read;			///< bytes decoded so far
+		bool						m_have_header;
+		bool						m_error;
+		int							m_resolution;
+		int							m_last_device;
+		core::int64					m_last_ticks;
+		int							m_driver_id;
+		std::vector<remote_device*> m_devices;		///< connected devices
+		std::vector<remote_device*> m_free;			///< removed devices for reuse, descriptions stay valid
+		remote_device*				m_cur;			///< device of the last record issued
+		int							m_cur_remote;	///< remote id m_cur was looked up for
+	};
+
+} // end namespace
+} // end namespace
+
+#endif // __INPUT_STREAM_H_5B93E0C7_1A64_4F2D_8C3B_E7049D2A61F8_
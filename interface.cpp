@@ -9,6 +9,9 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "interface.h"
 #include "input/driver_base.h"
+#include "input/timestamp.h"
+#include <algorithm>
+#include <new>
 
 //////////////////////////////////////////////////////////////////////////////
 // CLASS
@@ -19,14 +22,60 @@ namespace input
 {
 
 	/// constructor
-	interface::interface() :
+	interface::interface(allocator* alloc, int num_groups) :
+		m_alloc(alloc ? *alloc : allocator::get_heap()),
+		m_jobs(0),
+#if TYCHO_INPUT_LATENCY_STATS
+		m_dispatch_time(0),
+#endif
+		m_capture_rate(capture_thread::DefaultRate),
+		m_frame(0),
+		m_groups(0),
+		m_num_groups(num_groups > 0 ? num_groups : 0),
+#if TYCHO_INPUT_LATENCY_STATS
+		m_latency(0),
+#endif
+		m_binding_names(ReservedNames),
+		m_action_names(ReservedNames),
 		m_cur_driver_id(0)
 	{
+		TYCHO_ASSERT(num_groups > 0);
+		
+		// one block so walking the groups doesn't chase pointers
+		m_groups = (device_group*)m_alloc.allocate(m_num_groups * sizeof(device_group));
+		for(int i = 0; i < m_num_groups; ++i)
+			new(m_groups + i) device_group();
+#if TYCHO_INPUT_LATENCY_STATS
+		int num_histograms = m_num_groups * device_count;
+		m_latency = (latency_histogram*)m_alloc.allocate(num_histograms * sizeof(latency_histogram));
+		for(int i = 0; i < num_histograms; ++i)
+			new(m_latency + i) latency_histogram();
+		for(int i = 0; i < m_num_groups; ++i)
+			m_groups[i].m_latency = m_latency + i * device_count;
+#endif
+		
+		// size everything touched per update or per push up front so the steady state never allocates
+		m_cursors.reserve(ReservedDrivers);
+		m_merge_heap.reserve(ReservedDrivers);
+		m_devices.reserve(ReservedDevices);
+		m_device_states.reserve(ReservedDevices);
+		m_free_states.reserve(ReservedDevices);
+		m_queued_states.reserve(ReservedDevices + m_num_groups);
+		m_publishing.reserve(ReservedDevices + m_num_groups);
+		m_pending_groups.reserve(m_num_groups);
+		m_active_groups.reserve(m_num_groups);
+		m_combo_groups.reserve(m_num_groups);
+		m_batches.reserve(ReservedBatches);
+		m_free_batches.reserve(ReservedBatches);
+		m_binding_sets.reserve(ReservedNames);
+		m_combo_sets.reserve(ReservedNames);
+		m_coalesce.reserve(ReservedNames);
 	}
 	
 	/// destructor
 	interface::~interface()
 	{
+		m_capture.stop();
 		drivers::iterator it = m_drivers.begin();
 		drivers::iterator end = m_drivers.end();
 		for(; it != end; ++it)
@@ -34,38 +83,638 @@ namespace input
 			delete *it;
 		}
 		m_drivers.clear();
+		
+		for(size_t i = 0; i < m_rings.size(); ++i)
+			m_alloc.destroy(m_rings[i]);
+		m_rings.clear();
+		
+		for(size_t i = 0; i < m_device_states.size(); ++i)
+			m_alloc.destroy(m_device_states[i]);
+		m_device_states.clear();
+		for(size_t i = 0; i < m_free_states.size(); ++i)
+			m_alloc.destroy(m_free_states[i]);
+		m_free_states.clear();
+		
+		for(size_t i = 0; i < m_batches.size(); ++i)
+			m_alloc.destroy(m_batches[i]);
+		m_batches.clear();
+		for(size_t i = 0; i < m_free_batches.size(); ++i)
+			m_alloc.destroy(m_free_batches[i]);
+		m_free_batches.clear();
+		
+		for(size_t i = 0; i < m_binding_sets.size(); ++i)
+			m_alloc.destroy(m_binding_sets[i]);
+		m_binding_sets.clear();
+		for(size_t i = 0; i < m_combo_sets.size(); ++i)
+			m_alloc.destroy(m_combo_sets[i]);
+		m_combo_sets.clear();
+		
+		for(int i = 0; i < m_num_groups; ++i)
+			m_groups[i].~device_group();
+		m_alloc.deallocate(m_groups, m_num_groups * sizeof(device_group));
+		m_groups = 0;
+#if TYCHO_INPUT_LATENCY_STATS
+		m_alloc.deallocate(m_latency, m_num_groups * device_count * sizeof(latency_histogram));
+		m_latency = 0;
+#endif
 	}
 	
 	/// process all pending input
 	void interface::update()
 	{
-		drivers::iterator it = m_drivers.begin();
-		drivers::iterator end = m_drivers.end();
-		for(; it != end; ++it)
+		// drivers append their events to their own ring, the rings are then merged so events
+		// are dispatched in the order they were captured whichever driver they came from.
+		// when the capture thread is running it is the one updating the drivers.
+		bool poll = !m_capture.is_running();
+		if(poll)
 		{
-			(*it)->update(this);
-		}	
+			for(size_t i = 0; i < m_drivers.size(); ++i)
+				m_drivers[i]->update(m_rings[i]);
+		}
+		dispatch_rings();
+		if(!m_active_groups.empty())
+			dispatch_groups();
+		update_combos();
+		flush_pending_actions();
+		for(size_t i = 0; i < m_batches.size(); ++i)
+			flush_batch(m_batches[i]);
+		publish_states();
+		++m_frame;
 	}	
 	
+	/// start polling the drivers on a dedicated thread instead of from update(). 
+	void interface::start_capture_thread(int rate_hz)
+	{
+		m_capture.stop();
+		m_capture_rate = rate_hz;
+		m_capture.start(m_drivers, m_rings, rate_hz);
+	}
+	
+	/// stop the capture thread, drivers are polled from update() again.
+	void interface::stop_capture_thread()
+	{
+		m_capture.stop();
+	}
+	
+	/// start recording every event dispatched
+	bool interface::start_recording(const char* path)
+	{
+		const device_description* devices = m_devices.empty() ? 0 : &m_devices[0];
+		return m_recorder.open(path, devices, (int)m_devices.size());
+	}
+	
+	/// stop recording
+	void interface::stop_recording()
+	{
+		m_recorder.close();
+	}
+	
+	/// \returns the number of bytes used by a device group including its binding tables
+	size_t interface::get_group_memory_usage(int group_id) const
+	{
+		TYCHO_ASSERT(is_valid_group(group_id));
+		if(!is_valid_group(group_id))
+			return 0;
+		size_t size = m_groups[group_id].get_memory_usage();
+#if TYCHO_INPUT_LATENCY_STATS
+		size += device_count * sizeof(latency_histogram);
+#endif
+		return size;
+	}
+	
+	/// dispatch the pending packets of every driver's ring in timestamp order. Each ring
+	/// is already in order so this is a k-way merge, a heap picks the ring with the 
+	/// earliest packet which then runs until it passes the next earliest ring's packet.
+	/// Devices on different drivers rarely interleave closely so most updates are a 
+	/// handful of heap operations, a single ring with packets never touches the heap.
+	void interface::dispatch_rings()
+	{
+		m_cursors.clear();
+		for(size_t i = 0; i < m_rings.size(); ++i)
+		{
+			ring_cursor c;
+			c.ring = m_rings[i];
+			c.driver = m_drivers[i];
+			c.num_spans = c.ring->acquire(c.spans);
+			if(!c.num_spans)
+				continue;
+			c.span = 0;
+			c.pos = 0;
+			c.count = c.spans[0].count + (c.num_spans > 1 ? c.spans[1].count : 0);
+			m_cursors.push_back(c);
+		}
+		if(m_cursors.empty())
+			return;
+#if TYCHO_INPUT_LATENCY_STATS
+		// one clock read per update rather than per event, time spent in handlers
+		// during the pass isn't counted
+		m_dispatch_time = get_timestamp();
+#endif
+
+		cursor_later later = { &m_cursors[0] };
+		m_merge_heap.clear();
+		for(int i = 0; i < (int)m_cursors.size(); ++i)
+			m_merge_heap.push_back(i);
+		std::make_heap(m_merge_heap.begin(), m_merge_heap.end(), later);
+		while(!m_merge_heap.empty())
+		{
+			std::pop_heap(m_merge_heap.begin(), m_merge_heap.end(), later);
+			int c = m_merge_heap.back();
+			m_merge_heap.pop_back();
+			ring_cursor& cur = m_cursors[c];
+			
+			// run this ring until its next packet belongs after the head of the next ring
+			bool last = m_merge_heap.empty();
+			int bound = last ? -1 : m_merge_heap.front();
+			bool more;
+			do
+			{
+				dispatch_packet(cur.next(), cur.driver);
+				more = cur.advance();
+			}
+			while(more && (last || !later(c, bound)));
+			if(more)
+			{
+				m_merge_heap.push_back(c);
+				std::push_heap(m_merge_heap.begin(), m_merge_heap.end(), later);
+			}
+		}
+		
+		for(size_t i = 0; i < m_cursors.size(); ++i)
+			m_cursors[i].ring->release(m_cursors[i].count);
+	}
+	
+	/// dispatch a single packet to the group its device is bound to
+	void interface::dispatch_packet(const event_packet& pkt, const driver_base* driver)
+	{
+		// devices coming and going only change the device list, and are recorded with it.
+		// the description comes from the driver that issued the packet rather than the one
+		// the id names, a replayed device keeps the id of the driver that recorded it.
+		if(pkt.ptype == packet_type_device_added)
+		{
+			const device_description* desc = driver ? driver->find_device_desc(pkt.index) : 0;
+			if(desc)
+				add_device(*desc, pkt.timestamp);
+			return;
+		}
+		if(pkt.ptype == packet_type_device_removed)
+		{
+			remove_device(pkt.index, pkt.timestamp);
+			return;
+		}
+		
+		if(m_recorder.is_open())
+			m_recorder.record(m_frame, pkt);
+		device_router::route r = m_router.find(pkt.index);
+		if(r.slot >= 0)
+			apply_state(*m_device_states[r.slot], pkt);
+		if(r.group < 0)
+			return;
+		device_group* g = &m_groups[r.group];
+		device_type type = r.slot >= 0 ? m_devices[r.slot].type : device_unknown;
+		bool apply = group_applies(*g, pkt);
+		if(m_jobs)
+		{
+			device_group::queued_packet q = { pkt, type, apply };
+			g->m_queue.push_back(q);
+			if(!g->m_active)
+			{
+				g->m_active = true;
+				m_active_groups.push_back(g);
+			}
+			return;
+		}
+		if(apply)
+			apply_state(g->m_state, pkt);
+#if TYCHO_INPUT_LATENCY_STATS
+		g->m_dispatch_time = m_dispatch_time;
+#endif
+		g->dispatch(pkt, type);
+		if(!g->m_flush_queued && g->has_pending())
+		{
+			g->m_flush_queued = true;
+			m_pending_groups.push_back(g);
+		}
+	}
+	
+	/// dispatch groups in parallel on a job system
+	void interface::set_job_system(job_system* jobs)
+	{
+		if(!m_active_groups.empty())
+			dispatch_groups();
+		m_jobs = jobs;
+		for(int i = 0; i < m_num_groups; ++i)
+		{
+			m_groups[i].m_stage_batches = jobs != 0;
+			if(jobs)
+			{
+				m_groups[i].m_queue.reserve(device_group::ReservedQueue);
+				m_groups[i].m_staged.reserve(device_group::ReservedQueue);
+			}
+		}
+	}
+	
+	/// run every group with queued packets as a job. Everything shared between 
+	/// groups is touched afterwards on this thread.
+	void interface::dispatch_groups()
+	{
+		m_jobs->run(&interface::run_group_job, this, (int)m_active_groups.size());
+		for(size_t i = 0; i < m_active_groups.size(); ++i)
+		{
+			device_group* g = m_active_groups[i];
+			g->m_active = false;
+			if(!g->m_state.m_queued)
+			{
+				g->m_state.m_queued = true;
+				m_queued_states.push_back(&g->m_state);
+			}
+			finish_group(g);
+		}
+		m_active_groups.clear();
+	}
+	
+	/// job entry point, runs a single active group
+	void interface::run_group_job(void* context, int index)
+	{
+		interface* self = (interface*)context;
+		self->m_active_groups[index]->run_queue();
+	}
+	
+	/// run anything still queued or coalesced for a group and merge its staged
+	/// records into the shared batches, in the order the group produced them.
+	void interface::finish_group(device_group* g)
+	{
+		if(!g->m_queue.empty())
+		{
+			g->run_queue();
+			if(!g->m_state.m_queued)
+			{
+				g->m_state.m_queued = true;
+				m_queued_states.push_back(&g->m_state);
+			}
+		}
+		g->flush_pending();
+		for(size_t i = 0; i < g->m_staged.size(); ++i)
+			g->m_staged[i].batch->records.push_back(g->m_staged[i].record);
+		g->m_staged.clear();
+	}
+	
+	/// add a connected device to the device list, its group binding if any is
+	/// still in the router so it routes to the same group as before. Devices
+	/// arriving while recording are added to the recording so it can replay them.
+	void interface::add_device(const device_description& desc, core::int64 timestamp)
+	{
+		if(m_router.find(desc.id).slot >= 0)
+			return;
+		if(m_recorder.is_open())
+			m_recorder.record_device_added(m_frame, timestamp, desc);
+		m_router.set_slot(desc.id, (int)m_devices.size());
+		m_devices.push_back(desc);
+		m_device_states.push_back(create_state());
+	}
+	
+	/// remove a disconnected device from the device list. The last device is
+	/// moved into its slot so removal is constant time.
+	void interface::remove_device(int device_id, core::int64 timestamp)
+	{
+		int slot = m_router.find(device_id).slot;
+		if(slot < 0)
+			return;
+		if(m_recorder.is_open())
+			m_recorder.record_device_removed(m_frame, timestamp, device_id);
+		int group = m_router.find_group(device_id);
+		if(group >= 0)
+			release_group_keys(group, device_id);
+		input_state* state = m_device_states[slot];
+		if(state->m_queued)
+		{
+			for(size_t i = 0; i < m_queued_states.size(); ++i)
+			{
+				if(m_queued_states[i] == state)
+				{
+					m_queued_states[i] = m_queued_states.back();
+					m_queued_states.pop_back();
+					break;
+				}
+			}
+		}
+		m_free_states.push_back(state);
+		
+		int last = (int)m_devices.size() - 1;
+		if(slot != last)
+		{
+			m_devices[slot] = m_devices[last];
+			m_device_states[slot] = m_device_states[last];
+			m_router.set_slot(m_devices[slot].id, slot);
+		}
+		m_devices.pop_back();
+		m_device_states.pop_back();
+		m_router.set_slot(device_id, -1);
+	}
+	
+	/// apply a packet to a device or group state, queuing it for publishing
+	void interface::apply_state(input_state& state, const event_packet& pkt)
+	{
+		state.apply(pkt);
+		if(!state.m_queued)
+		{
+			state.m_queued = true;
+			m_queued_states.push_back(&state);
+		}
+	}
+	
+	/// \returns false for a key going up or down while another device in the group holds it
+	bool interface::group_applies(const device_group& g, const event_packet& pkt) const
+	{
+		if(pkt.ptype != packet_type_keyboard || g.get_device_ids().size() < 2)
+			return true;
+		int k = pkt.keyboard.key;
+		return k <= key_invalid || k >= key_count || !held_by_other(g, pkt.index, k);
+	}
+	
+	/// \returns true if a device in the group other than device_id holds a key
+	bool interface::held_by_other(const device_group& g, int device_id, int key) const
+	{
+		const std::vector<int>& ids = g.get_device_ids();
+		for(size_t i = 0; i < ids.size(); ++i)
+		{
+			if(ids[i] == device_id)
+				continue;
+			int slot = m_router.find(ids[i]).slot;
+			if(slot >= 0 && m_device_states[slot]->is_held(key))
+				return true;
+		}
+		return false;
+	}
+	
+	/// release the keys a device holds from its group's state when it leaves the group
+	void interface::release_group_keys(int group, int device_id)
+	{
+		int slot = m_router.find(device_id).slot;
+		if(slot < 0)
+			return;
+		const input_state& state = *m_device_states[slot];
+		device_group& g = m_groups[group];
+		event_packet pkt;
+		pkt.timestamp = get_timestamp();
+		pkt.index = device_id;
+		pkt.ptype = packet_type_keyboard;
+		for(int k = key_invalid + 1; k < key_count; ++k)
+		{
+			if(state.is_held(k) && g.m_state.is_held(k) && !held_by_other(g, device_id, k))
+			{
+				pkt.keyboard = make_keyboard_packet((key_type)k, key_state_up);
+				apply_state(g.m_state, pkt);
+			}
+		}
+	}
+	
+	/// publish all states modified this update. States only need publishing if 
+	/// they changed or were published last frame with single frame state that
+	/// needs clearing so idle devices and groups cost nothing.
+	void interface::publish_states()
+	{
+		m_publishing.swap(m_queued_states);
+		m_queued_states.clear();
+		for(size_t i = 0; i < m_publishing.size(); ++i)
+		{
+			input_state* state = m_publishing[i];
+			if(state->publish())
+				m_queued_states.push_back(state);
+			else
+				state->m_queued = false;
+		}
+		m_publishing.clear();
+	}
+	
+	/// dispatch the coalesced actions of every group that has any. Handlers may 
+	/// feed more events in while this runs so the list is walked by index.
+	void interface::flush_pending_actions()
+	{
+		for(size_t i = 0; i < m_pending_groups.size(); ++i)
+		{
+			device_group* g = m_pending_groups[i];
+			g->m_flush_queued = false;
+			g->flush_pending();
+		}
+		m_pending_groups.clear();
+	}
+	
+	/// hand an action to its handler, directly or through its batch
+	inline void interface::device_group::dispatch_action(const action_handler& h, const action_record& r, device_type type)
+	{
+#if TYCHO_INPUT_LATENCY_STATS
+		// events fed in directly can be stamped after the pass started, those are counted as 0
+		core::int64 latency_us = (m_dispatch_time - r.timestamp) / 1000;
+		m_latency[type].record(latency_us <= 0 ? 0 : (latency_us > 0xffffffff ? 0xffffffff : (core::uint32)latency_us));
+#else
+		(void)type;
+#endif
+		if(h.batch)
+		{
+			if(m_stage_batches)
+			{
+				staged_record s = { h.batch, r };
+				m_staged.push_back(s);
+			}
+			else
+			{
+				h.batch->records.push_back(r);
+			}
+			return;
+		}
+		switch(r.kind)
+		{
+			case packet_type_keyboard: h.handler->handle_key(r.action_id, r.keyboard.key, r.keyboard.state); break;
+			case packet_type_mouse: h.handler->handle_mouse(r.action_id, r.mouse.dx, r.mouse.dy); break;
+			case packet_type_axis: h.handler->handle_axis(r.action_id, r.value); break;
+			default: break;
+		}
+	}
+	
+	/// \returns the batch for a handler, creating it on first use
+	interface::handler_batch* interface::acquire_batch(input_handler* handler)
+	{
+		for(size_t i = 0; i < m_batches.size(); ++i)
+		{
+			if(m_batches[i]->handler == handler)
+			{
+				++m_batches[i]->num_refs;
+				return m_batches[i];
+			}
+		}
+		handler_batch* batch;
+		if(!m_free_batches.empty())
+		{
+			batch = m_free_batches.back();
+			m_free_batches.pop_back();
+		}
+		else
+		{
+			batch = m_alloc.create<handler_batch>();
+		}
+		batch->handler = handler;
+		batch->num_refs = 1;
+		m_batches.push_back(batch);
+		return batch;
+	}
+	
+	/// drop a reference to a batch. Once nothing uses it the handler gets anything 
+	/// still queued straight away as it may not outlive the group.
+	void interface::release_batch(handler_batch* batch)
+	{
+		if(--batch->num_refs > 0)
+			return;
+		flush_batch(batch);
+		for(size_t i = 0; i < m_batches.size(); ++i)
+		{
+			if(m_batches[i] == batch)
+			{
+				m_batches.erase(m_batches.begin() + i);
+				break;
+			}
+		}
+		// keep it and the capacity of its record lists for the next handler that wants one
+		batch->handler = 0;
+		m_free_batches.push_back(batch);
+	}
+	
+	/// deliver a batch's records to its handler. The records are swapped out first so
+	/// actions dispatched from inside the handler are kept for the next flush.
+	void interface::flush_batch(handler_batch* batch)
+	{
+		if(batch->records.empty())
+			return;
+		batch->flushing.swap(batch->records);
+		batch->handler->handle_batch(&batch->flushing[0], (int)batch->flushing.size());
+		batch->flushing.clear();
+	}
+	
+	/// \returns the coalescing policy to use for an action
+	coalesce_policy interface::resolve_coalesce_policy(int action_id, const action* a) const
+	{
+		if(action_id < (int)m_coalesce.size() && m_coalesce[action_id] != coalesce_default)
+			return m_coalesce[action_id];
+		switch(a->requirements)
+		{
+			case event_type_mouse: return coalesce_sum;
+			case event_type_axis: return coalesce_latest;
+			default: return coalesce_none;
+		}
+	}
+	
+	/// \returns the state of a single device, unknown devices return an empty state.
+	const frame_state& interface::get_device_state(int device_id) const
+	{
+		static const input_state empty;
+		int slot = m_router.find(device_id).slot;
+		if(slot < 0)
+			return empty.get();
+		return m_device_states[slot]->get();
+	}
+	
+	/// \returns the combined state of all devices bound to a group
+	const frame_state& interface::get_group_state(int group_id) const
+	{
+		static const input_state empty;
+		TYCHO_ASSERT(is_valid_group(group_id));
+		if(!is_valid_group(group_id))
+			return empty.get();
+		return m_groups[group_id].m_state.get();
+	}
+	
+	/// \returns latencies of all events from devices of a type
+	latency_histogram interface::get_device_latency(device_type type) const
+	{
+		TYCHO_ASSERT(type >= 0 && type < device_count);
+		latency_histogram h;
+#if TYCHO_INPUT_LATENCY_STATS
+		for(int i = 0; i < m_num_groups; ++i)
+			h.merge(m_groups[i].m_latency[type]);
+#else
+		(void)type;
+#endif
+		return h;
+	}
+	
+	/// \returns latencies of all events dispatched to a group
+	latency_histogram interface::get_group_latency(int group_id) const
+	{
+		TYCHO_ASSERT(is_valid_group(group_id));
+		latency_histogram h;
+#if TYCHO_INPUT_LATENCY_STATS
+		if(!is_valid_group(group_id))
+			return h;
+		for(int i = 0; i < device_count; ++i)
+			h.merge(m_groups[group_id].m_latency[i]);
+#else
+		(void)group_id;
+#endif
+		return h;
+	}
+	
+	/// clear all latency statistics
+	void interface::reset_latency_stats()
+	{
+#if TYCHO_INPUT_LATENCY_STATS
+		for(int i = 0; i < m_num_groups; ++i)
+			for(int t = 0; t < device_count; ++t)
+				m_groups[i].m_latency[t].reset();
+#endif
+	}
+	
+	/// \returns the number of events dropped because a driver's event ring overflowed
+	core::uint32 interface::get_num_dropped_events() const
+	{
+		core::uint32 num_dropped = 0;
+		for(size_t i = 0; i < m_rings.size(); ++i)
+			num_dropped += m_rings[i]->get_num_dropped();
+		return num_dropped;
+	}
+	
 	/// bind a device to an input group
 	/// \param device_id obtained from the device_description structure.
-	/// \param input_group group to bind to. Must be in range [0,7]
-	void interface::bind_device(int input_group, int device_id)
+	/// \param input_group group to bind to. Must be in range [0,get_num_groups())
+	bool interface::bind_device(int input_group, int device_id)
 	{
+		TYCHO_ASSERT(is_valid_group(input_group));
+		if(!is_valid_group(input_group))
+			return false;
+		unbind_device(device_id);
 		m_groups[input_group].add_device(device_id);
+		m_router.set_group(device_id, input_group);
+		return true;
+	}
+	
+	/// remove a device from the group it is bound to.
+	void interface::unbind_device(int device_id)
+	{
+		int group = m_router.find_group(device_id);
+		if(group >= 0)
+		{
+			release_group_keys(group, device_id);
+			m_groups[group].remove_device(device_id);
+			m_router.clear(device_id);
+		}
 	}
 	
 	/// add an input driver, this takes ownership of the pointer
 	void interface::add_driver(driver_base* driver)
 	{
-		if(driver->initialise(m_cur_driver_id++))
+		// the capture thread holds its own copy of the driver list so restart it around the change
+		bool capturing = m_capture.is_running();
+		m_capture.stop();
+		int driver_id = m_cur_driver_id++;
+		if(driver->initialise(driver_id))
 		{
 			m_drivers.push_back(driver);
+			m_rings.push_back(m_alloc.create<event_ring>());
+			core::int64 now = get_timestamp();
 			for(int i = 0; i < driver->get_num_devices(); ++i)
-			{
-				m_devices.push_back(*driver->get_device_desc(i));
-			}
+				add_device(*driver->get_device_desc(i), now);
 		}
+		if(capturing)
+			m_capture.start(m_drivers, m_rings, m_capture_rate);
 	}
 	
 	/// \returns list of all available devices available for input
@@ -73,106 +722,232 @@ namespace input
 	{ 
 		return m_devices; 
 	}
+	
+	/// \returns the description of a connected device or 0
+	const device_description* interface::find_device(int device_id) const
+	{
+		int slot = m_router.find(device_id).slot;
+		return slot < 0 ? 0 : &m_devices[slot];
+	}
 
 
 	void interface::push_action_group(int group_id, const char* group_name, const action *group, input_handler *handler)
 	{
+		TYCHO_ASSERT(is_valid_group(group_id));
+		if(!is_valid_group(group_id))
+			return;
 		const action* a = group;
 		device_group* g = &m_groups[group_id];
-		TYCHO_ASSERT(g);
+		
+		// anything queued or coalesced so far belongs to the handlers being shadowed
+		finish_group(g);
+		handler_batch* batch = 0;
+		if(a && a->name && handler->wants_batches())
+			batch = acquire_batch(handler);
 		while(a && a->name)
 		{
+			int action_id = m_action_names.intern(a->name);
 			action_handler ahandler;
 			ahandler.act = a;
 			ahandler.handler = handler;
-			g->m_output_map.push(a->name, ahandler);
+			ahandler.coalesce = resolve_coalesce_policy(action_id, a);
+			ahandler.batch = batch;
+			g->m_output_map.push(action_id, ahandler);
 			++a;
 		}
 		
 		// lookup its corresponding binding set and push them on
-		binding_map::iterator it = m_bindings.find(group_name);
-		if(it != m_bindings.end())
-			push_bindings(group_id, it->second);
+		const binding_set* bindings = find_bindings(group_name);
+		if(bindings)
+			push_bindings(group_id, *bindings);
+		const combo_set* combos = find_combos(group_name);
+		if(combos)
+		{
+			if(g->m_combos.empty())
+				m_combo_groups.push_back(g);
+			g->m_combos.push(combos);
+		}
 	}
 	
 	void interface::pop_action_group(int group_id, const char* group_name, const action *group)
 	{
-		// lookup its corresponding binding set and push them on
-		binding_map::iterator it = m_bindings.find(group_name);
-		if(it != m_bindings.end())
-			pop_bindings(group_id, it->second);
-		const action* a = group;
+		TYCHO_ASSERT(is_valid_group(group_id));
+		if(!is_valid_group(group_id))
+			return;
+		
+		// deliver anything queued or coalesced for the handlers before they go away
 		device_group* g = &m_groups[group_id];
-		TYCHO_ASSERT(g);
+		finish_group(g);
+		
+		// lookup its corresponding binding set and pop them off
+		const action* a = group;
+		const binding_set* bindings = find_bindings(group_name);
+		if(bindings)
+			pop_bindings(group_id, *bindings);
+		const combo_set* combos = find_combos(group_name);
+		if(combos)
+		{
+			g->m_combos.pop(combos);
+			if(g->m_combos.empty())
+				m_combo_groups.erase(std::find(m_combo_groups.begin(), m_combo_groups.end(), g));
+		}
+		handler_batch* batch = 0;
+		if(a && a->name)
+		{
+			const action_handler* h = g->m_output_map.find(m_action_names.find(a->name));
+			if(h)
+				batch = h->batch;
+		}
 		while(a && a->name)
 		{
-			g->m_output_map.pop(a->name);
+			g->m_output_map.pop(m_action_names.find(a->name));
 			++a;
 		}
+		if(batch)
+			release_batch(batch);
 	}
 	
 	void interface::register_bindings(const char* name, const binding* bindings)
 	{
-		TYCHO_ASSERT(m_bindings.find(name) == m_bindings.end());
-		m_bindings.insert(std::make_pair(name, bindings));
+		TYCHO_ASSERT(!find_bindings(name));
+		
+		// compile the set once here, pushing and popping it only moves a pointer
+		binding_set* set = m_alloc.create<binding_set>();
+		set->compile(bindings, m_action_names);
+		int id = m_binding_names.intern(name);
+		if(id >= (int)m_binding_sets.size())
+			m_binding_sets.resize(id + 1, 0);
+		m_binding_sets[id] = set;
+	}
+	
+	/// \returns the binding set registered under a name or 0. Hashes the name in place
+	/// so looking up a set when pushing an action group doesn't allocate.
+	const binding_set* interface::find_bindings(const char* name) const
+	{
+		int id = m_binding_names.find(name);
+		return id >= 0 && id < (int)m_binding_sets.size() ? m_binding_sets[id] : 0;
+	}
+	
+	/// register a set of combos pushed and popped with the action group of the same name
+	void interface::register_combos(const char* name, const combo* combos)
+	{
+		TYCHO_ASSERT(!find_combos(name));
+		combo_set* set = m_alloc.create<combo_set>();
+		set->compile(combos, m_action_names);
+		int id = m_binding_names.intern(name);
+		if(id >= (int)m_combo_sets.size())
+			m_combo_sets.resize(id + 1, 0);
+		m_combo_sets[id] = set;
+	}
+	
+	/// \returns the combo set registered under a name or 0
+	const combo_set* interface::find_combos(const char* name) const
+	{
+		int id = m_binding_names.find(name);
+		return id >= 0 && id < (int)m_combo_sets.size() ? m_combo_sets[id] : 0;
+	}
+	
+	/// complete holds in every group that has any in progress. Runs on this thread
+	/// after any parallel dispatch so staged records are merged straight after. Only
+	/// groups with combos pushed can have holds so the others are never touched.
+	void interface::update_combos()
+	{
+		core::int64 now = 0;
+		for(size_t i = 0; i < m_combo_groups.size(); ++i)
+		{
+			device_group* g = m_combo_groups[i];
+			if(!g->m_combos.has_holds())
+				continue;
+			if(!now)
+				now = get_timestamp();
+			g->update_combos(now);
+			finish_group(g);
+		}
+	}
+	
+	/// \returns a device state, reusing one freed by a removed device if possible
+	input_state* interface::create_state()
+	{
+		if(m_free_states.empty())
+			return m_alloc.create<input_state>();
+		input_state* state = m_free_states.back();
+		m_free_states.pop_back();
+		*state = input_state();
+		return state;
+	}
+	
+	/// override how mouse and axis events for an action are combined within an update
+	void interface::set_coalesce_policy(const char* action_name, coalesce_policy policy)
+	{
+		int action_id = m_action_names.intern(action_name);
+		if(action_id >= (int)m_coalesce.size())
+			m_coalesce.resize(action_id + 1, coalesce_default);
+		m_coalesce[action_id] = policy;
 	}
 	
 	/// push a key binding group on the stack, these will get first crack at binding to actions
-	void interface::push_bindings(int group_id, const binding* bindings)
+	void interface::push_bindings(int group_id, const binding_set& bindings)
 	{
-		const binding* b = bindings;
 		device_group* g = &m_groups[group_id];
 		TYCHO_ASSERT(g);
-		while(b && b->action)
-		{
-			g->m_input_map.push(b->trigger, b->action);
-			++b;
-		}
+		g->m_input_map.push(&bindings);
 	}
 	
 	/// pop a group of key bindings off the stack
-	void interface::pop_bindings(int group_id, const binding* bindings)
+	void interface::pop_bindings(int group_id, const binding_set& bindings)
 	{
-		const binding* b = bindings;
-		while(b && b->action)
-		{
-			device_group* g = &m_groups[group_id];
-			TYCHO_ASSERT(g);
-			g->m_input_map.pop(b->trigger);
-			++b;
-		}	
+		device_group* g = &m_groups[group_id];
+		TYCHO_ASSERT(g);
+		g->m_input_map.pop(&bindings);
 	}
 		
-	void interface::handle_mouse_event(int device_id, const mouse_packet &pkt)
+	void interface::handle_mouse_event(int device_id, const mouse_packet &mouse)
 	{
-		device_group* g = get_device_group(device_id);
-		if(g)
-			g->handle_mouse_event(device_id, pkt);
+		event_packet pkt;
+		pkt.timestamp = get_timestamp();
+		pkt.index = device_id;
+		pkt.ptype = packet_type_mouse;
+		pkt.mouse = mouse;
+		dispatch_packet(pkt, 0);
 	}
 	
-	void interface::handle_keyboard_event(int device_id, const keyboard_packet& pkt)
+	void interface::handle_keyboard_event(int device_id, const keyboard_packet& keyboard)
 	{
-		device_group* g = get_device_group(device_id);
-		if(g)
-			g->handle_keyboard_event(device_id, pkt);
+		event_packet pkt;
+		pkt.timestamp = get_timestamp();
+		pkt.index = device_id;
+		pkt.ptype = packet_type_keyboard;
+		pkt.keyboard = keyboard;
+		dispatch_packet(pkt, 0);
 	}
 	
-	void interface::handle_axis_event(int device_id, const axis_packet& pkt)
+	void interface::handle_axis_event(int device_id, const axis_packet& axis)
 	{
-		device_group* g = get_device_group(device_id);
-		if(g)
-			g->handle_axis_event(device_id, pkt);
+		event_packet pkt;
+		pkt.timestamp = get_timestamp();
+		pkt.index = device_id;
+		pkt.ptype = packet_type_axis;
+		pkt.axis = axis;
+		dispatch_packet(pkt, 0);
 	}
 
-	/// \todo O(N), make O(1)
+	void interface::handle_device_added(const device_description& desc)
+	{
+		add_device(desc, get_timestamp());
+	}
+	
+	void interface::handle_device_removed(int device_id)
+	{
+		remove_device(device_id, get_timestamp());
+	}
+
+	/// find the group a device is mapped to
 	interface::device_group* interface::get_device_group(int device_id)
 	{
-		for(int i = 0; i < MaxGroups; ++i)
-		{
-			if(m_groups[i].contains_device(device_id))
-				return &m_groups[i];
-		}
-		return 0;
+		int group = m_router.find_group(device_id);
+		if(group < 0)
+			return 0;
+		return &m_groups[group];
 	}
 
 	int interface::enumerate_controllers(device_description const * *out_devices, int output_size) const
@@ -181,7 +956,8 @@ namespace input
 		for(size_t i = 0; i < m_devices.size(); ++i)
 		{
 			if(m_devices[i].type == device_xenoncontroller ||
-			   m_devices[i].type == device_gccontroller)
+			   m_devices[i].type == device_gccontroller ||
+			   m_devices[i].type == device_gamepad)
 			{
 				out_devices[num_controllers++] = &m_devices[i];
 				if(num_controllers == output_size)
@@ -196,72 +972,255 @@ namespace input
 	//////////////////////////////////////////////////////////////////////////////
 
 	interface::device_group::device_group() :
-		m_num_devices(0)
+		m_flush_queued(false),
+		m_stage_batches(false),
+		m_active(false),
+#if TYCHO_INPUT_LATENCY_STATS
+		m_latency(0),
+		m_dispatch_time(0),
+#endif
+		m_device_ids()
 	{
-		for(int i = 0; i < MaxDevices; ++i)
-			m_device_ids[i] = -1;
+		m_device_ids.reserve(ReservedDevices);
+		m_pending.reserve(ReservedPending);
+		m_flushing.reserve(ReservedPending);
 	}
 	
 	void interface::device_group::add_device(int device_id)
 	{
-//		TYCHO_ASSERT(!contains_device(device_id));
-		m_device_ids[m_num_devices++] = device_id;
+		TYCHO_ASSERT(!contains_device(device_id));
+		m_device_ids.push_back(device_id);
 	}
 	
 	void interface::device_group::remove_device(int device_id)
 	{
-		for(int i = 0; i < MaxDevices; ++i)
-		{
-			if(m_device_ids[i] == device_id)
-			{
-				m_device_ids[i] = -1;
-				--m_num_devices;
-				break;
-			}
-		}
+		// order doesn't matter so the last device fills the gap
+		std::vector<int>::iterator it = std::find(m_device_ids.begin(), m_device_ids.end(), device_id);
+		if(it == m_device_ids.end())
+			return;
+		*it = m_device_ids.back();
+		m_device_ids.pop_back();
 	}
 		
 	bool interface::device_group::contains_device(int device_id)
 	{
-		for(int i = 0; i < MaxDevices; ++i)
-		{
-			if(m_device_ids[i] == device_id)
-			{
-				return true;
-			}
-		}
-		return false;	
+		return std::find(m_device_ids.begin(), m_device_ids.end(), device_id) != m_device_ids.end();
 	}
 
-	/// takes an input and finds the key binding that maps it 
-	interface::action_handler* interface::device_group::map_input_to_action(const input& i)
+	/// takes an input code and finds the key binding that maps it 
+	interface::action_handler* interface::device_group::map_input_to_action(int input_code)
 	{
-		const char** action_name = m_input_map.find(i);
-		if(action_name)
-			return m_output_map.find(*action_name);
+		int action_id = m_input_map.find(input_code);
+		if(action_id >= 0)
+			return m_output_map.find(action_id);
 			
 		return 0;
 	}
 
-	void interface::device_group::handle_mouse_event(int, const mouse_packet& pkt)
+	/// takes an input code and finds the key binding that maps it and the action's interned id
+	interface::action_handler* interface::device_group::map_input_to_action(int input_code, int& action_id)
 	{
-		action_handler* handler = map_input_to_action(make_mouse_input());
-		if(handler)
-			handler->handler->handle_mouse(handler->act->id, pkt.dx, pkt.dy);			
+		action_id = m_input_map.find(input_code);
+		if(action_id < 0)
+			return 0;
+		return m_output_map.find(action_id);
+	}
+
+	/// \returns the number of bytes used by the group
+	size_t interface::device_group::get_memory_usage() const
+	{
+		// binding sets are shared between groups so only the layer stack is counted
+		return sizeof(device_group) - sizeof(combo_matcher) + m_combos.get_memory_usage() + 
+			   m_input_map.get_memory_usage() + m_output_map.get_memory_usage() +
+			   (m_pending.capacity() + m_flushing.capacity()) * sizeof(pending_action) + 
+			   (m_pending_slots.capacity() + m_device_ids.capacity()) * sizeof(int);
 	}
 	
-	void interface::device_group::handle_keyboard_event(int, const keyboard_packet& pkt)
+	/// \returns the pending entry for an action and packet type, creating it if needed
+	interface::device_group::pending_action& interface::device_group::get_pending(int action_id, const action_handler& handler, const event_packet& pkt, device_type type)
 	{
-		action_handler* handler = map_input_to_action(make_keyboard_input(pkt.key, pkt.state));
-		if(handler)
-			handler->handler->handle_key(handler->act->id, pkt.key, pkt.state);		
+		packet_type ptype = pkt.ptype;
+		int slot = action_id * 2 + (ptype == packet_type_axis ? 1 : 0);
+		if(slot >= (int)m_pending_slots.size())
+			m_pending_slots.resize(slot + 1 + m_pending_slots.size(), -1);
+		int& index = m_pending_slots[slot];
+		if(index < 0)
+		{
+			index = (int)m_pending.size();
+			pending_action p = { handler, ptype, slot, pkt.timestamp, type, 0, 0, 0 };
+			m_pending.push_back(p);
+		}
+		return m_pending[index];
 	}
 	
-	void interface::device_group::handle_axis_event(int, const axis_packet& pkt)
+	/// dispatch all coalesced actions in the order they first arrived. The pending list is
+	/// swapped out first so handlers that cause more input to be dispatched start a new one.
+	void interface::device_group::flush_pending()
 	{
-		action_handler* handler = map_input_to_action(make_axis_input(pkt.axis));
+		if(m_pending.empty())
+			return;
+#if TYCHO_INPUT_LATENCY_STATS
+		m_dispatch_time = get_timestamp();
+#endif
+		m_flushing.swap(m_pending);
+		for(size_t i = 0; i < m_flushing.size(); ++i)
+			m_pending_slots[m_flushing[i].slot] = -1;
+		for(size_t i = 0; i < m_flushing.size(); ++i)
+		{
+			const pending_action& p = m_flushing[i];
+			action_record r;
+			r.action_id = p.handler.act->id;
+			r.timestamp = p.timestamp;
+			r.kind = p.ptype;
+			if(p.ptype == packet_type_mouse)
+				r.mouse = make_mouse_packet(p.dx, p.dy);
+			else
+				r.value = p.value;
+			dispatch_action(p.handler, r, p.type);
+		}
+		m_flushing.clear();
+	}
+
+	/// dispatch a packet from a device of the given type to the group's handlers
+	void interface::device_group::dispatch(const event_packet& pkt, device_type type)
+	{
+		switch(pkt.ptype)
+		{
+			case packet_type_keyboard: handle_keyboard_event(pkt, type); break;
+			case packet_type_mouse: handle_mouse_event(pkt, type); break;
+			case packet_type_axis: handle_axis_event(pkt, type); break;
+			default: break;
+		}
+	}
+	
+	/// apply and dispatch every queued packet then flush coalesced actions. Only
+	/// touches the group so groups can be run on different threads.
+	void interface::device_group::run_queue()
+	{
+#if TYCHO_INPUT_LATENCY_STATS
+		m_dispatch_time = get_timestamp();
+#endif
+		for(size_t i = 0; i < m_queue.size(); ++i)
+		{
+			if(m_queue[i].apply)
+				m_state.apply(m_queue[i].packet);
+			dispatch(m_queue[i].packet, m_queue[i].type);
+		}
+		m_queue.clear();
+		flush_pending();
+	}
+
+	void interface::device_group::handle_mouse_event(const event_packet& pkt, device_type type)
+	{
+		int action_id;
+		action_handler* handler = map_input_to_action(input_code_mouse, action_id);
+		if(!handler)
+			return;
+		if(handler->coalesce == coalesce_none)
+		{
+			action_record r;
+			r.action_id = handler->act->id;
+			r.timestamp = pkt.timestamp;
+			r.kind = packet_type_mouse;
+			r.mouse = pkt.mouse;
+			dispatch_action(*handler, r, type);
+			return;
+		}
+		pending_action& p = get_pending(action_id, *handler, pkt, type);
+		if(handler->coalesce == coalesce_sum)
+		{
+			p.dx += pkt.mouse.dx;
+			p.dy += pkt.mouse.dy;
+		}
+		else
+		{
+			p.dx = pkt.mouse.dx;
+			p.dy = pkt.mouse.dy;
+		}
+	}
+	
+	/// dispatch holds that have completed
+	void interface::device_group::update_combos(core::int64 now)
+	{
+		combo_matcher::match matches[combo_matcher::MaxMatches];
+		int num_matches = m_combos.update(now, matches);
+#if TYCHO_INPUT_LATENCY_STATS
+		// the group's last dispatch pass may be long gone, holds are late by however
+		// long after their hold time ran out this update came along
+		if(num_matches)
+			m_dispatch_time = now;
+#endif
+		dispatch_combos(matches, num_matches, device_unknown);
+	}
+	
+	/// dispatch matched combos to their actions' handlers as a press of the trigger
+	void interface::device_group::dispatch_combos(const combo_matcher::match* matches, int num_matches, device_type type)
+	{
+		for(int i = 0; i < num_matches; ++i)
+		{
+			action_handler* handler = m_output_map.find(matches[i].action_id);
+			if(!handler)
+				continue;
+			action_record r;
+			r.action_id = handler->act->id;
+			r.timestamp = matches[i].timestamp;
+			r.kind = packet_type_keyboard;
+			r.keyboard = make_keyboard_packet(matches[i].key, key_state_down);
+			dispatch_action(*handler, r, type);
+		}
+	}
+	
+	void interface::device_group::handle_keyboard_event(const event_packet& pkt, device_type type)
+	{
+		// combos see every edge so held keys are tracked even while none are pushed
+		if(pkt.keyboard.state == key_state_down)
+		{
+			combo_matcher::match matches[combo_matcher::MaxMatches];
+			bool consumed;
+			int num_matches = m_combos.key_down(pkt.keyboard.key, pkt.timestamp, matches, consumed);
+			if(num_matches)
+				dispatch_combos(matches, num_matches, type);
+			if(consumed)
+				return;
+		}
+		else if(pkt.keyboard.state == key_state_up)
+		{
+			m_combos.key_up(pkt.keyboard.key);
+		}
+
+		action_handler* handler = map_input_to_action(get_input_code(make_keyboard_input(pkt.keyboard.key, pkt.keyboard.state)));
 		if(handler)
-			handler->handler->handle_axis(handler->act->id, pkt.value);	
+		{
+			action_record r;
+			r.action_id = handler->act->id;
+			r.timestamp = pkt.timestamp;
+			r.kind = packet_type_keyboard;
+			r.keyboard = pkt.keyboard;
+			dispatch_action(*handler, r, type);
+		}
+	}
+	
+	void interface::device_group::handle_axis_event(const event_packet& pkt, device_type type)
+	{
+		int action_id;
+		action_handler* handler = map_input_to_action(get_input_code(make_axis_input(pkt.axis.axis)), action_id);
+		if(!handler)
+			return;
+		if(handler->coalesce == coalesce_none)
+		{
+			action_record r;
+			r.action_id = handler->act->id;
+			r.timestamp = pkt.timestamp;
+			r.kind = packet_type_axis;
+			r.value = pkt.axis.value;
+			dispatch_action(*handler, r, type);
+			return;
+		}
+		pending_action& p = get_pending(action_id, *handler, pkt, type);
+		if(handler->coalesce == coalesce_sum)
+			p.value += pkt.axis.value;
+		else
+			p.value = pkt.axis.value;
 	}
 
 } // end namespace
@@ -15,12 +15,21 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "input/input_abi.h"
 #include "input/types.h"
+#include "input/allocator.h"
 #include "input/driver_base.h"
+#include "input/device_router.h"
+#include "input/event_ring.h"
+#include "input/capture_thread.h"
+#include "input/binding_index.h"
+#include "input/binding_set.h"
+#include "input/combo_matcher.h"
+#include "input/name_table.h"
+#include "input/input_recorder.h"
+#include "input/input_state.h"
+#include "input/job_system.h"
+#include "input/latency_histogram.h"
 #include "core/debug/assert.h"
-#include "core/containers/scoped_hash_table.h"
 #include <vector>
-#include <map>
-#include <string>
 
 //////////////////////////////////////////////////////////////////////////////
 // CLASS
@@ -38,9 +47,18 @@ namespace input
     public:		
 		typedef std::vector<device_description> devices;
 		typedef std::vector<driver_base*> drivers;
+		
+		static const int DefaultGroups = 8;	///< number of input groups unless told otherwise
 
 		/// constructor
-		interface();
+		/// \param alloc allocator for the drivers' rings, device states, binding sets and
+		///		   handler batches, 0 to use the heap. Must outlive the interface. Containers
+		///		   are sized up front so once every device, binding set and handler has been 
+		///		   seen update() and pushing or popping action groups don't allocate.
+		/// \param num_groups number of input groups, e.g. one per local player or one per
+		///		   bot on a server. Groups are stored contiguously and only the ones that 
+		///		   receive input or have holds in progress are visited by update().
+		explicit interface(allocator* alloc = 0, int num_groups = DefaultGroups);
 		
 		/// destructor
 		~interface();
@@ -51,13 +69,102 @@ namespace input
 		/// add an input driver, this takes ownership of the pointer
 		void add_driver(driver_base* driver);
 		
-		/// \returns list of all available devices available for input
+		/// start polling the drivers on a dedicated thread instead of from update(). 
+		/// update() then only dispatches the events captured since the last call.
+		/// \param rate_hz number of times per second to poll the drivers.
+		void start_capture_thread(int rate_hz = capture_thread::DefaultRate);
+		
+		/// stop the capture thread, drivers are polled from update() again.
+		void stop_capture_thread();
+		
+		/// \returns true if drivers are being polled on the capture thread
+		bool is_capture_thread_running() const { return m_capture.is_running(); }
+		
+		/// start recording every event dispatched to a file that can be played back
+		/// with a replay_driver. The currently available devices are stored with it.
+		bool start_recording(const char* path);
+		
+		/// stop recording
+		void stop_recording();
+		
+		/// \returns true if recording
+		bool is_recording() const { return m_recorder.is_open(); }
+		
+		/// dispatch groups in parallel. update() then routes events into per group 
+		/// queues and runs each group with events as a job, events are still handled
+		/// in order within a group. Handlers shared between groups must be thread safe,
+		/// batched handlers are as their records are merged after the jobs complete.
+		/// Handlers must not push or pop action groups while running in parallel.
+		/// \param jobs job system to use or 0 to dispatch serially, not owned.
+		void set_job_system(job_system* jobs);
+		
+		/// \returns list of all available devices available for input. Devices are added
+		/// and removed as they are plugged in so the order is not stable.
 		const devices& get_devices() const;
 		
+		/// \returns the description of a connected device or 0
+		const device_description* find_device(int device_id) const;
+		
+		/// \name polled state
+		/// state as of the end of the last update. These can be used instead of or as well
+		/// as input handlers, they are O(1) and don't allocate.
+		//@{
+		/// \returns the state of a single device, unknown devices return an empty state.
+		const frame_state& get_device_state(int device_id) const;
+		
+		/// \returns the combined state of all devices bound to a group, groups out of range
+		///			 return an empty state.
+		const frame_state& get_group_state(int group_id) const;
+		
+		/// \returns true if the key is held on any device in the group
+		bool is_down(int group_id, key_type k) const { return get_group_state(group_id).is_down(k); }
+		
+		/// \returns true if the key went down on any device in the group during the last update
+		bool was_pressed_this_frame(int group_id, key_type k) const { return get_group_state(group_id).was_pressed_this_frame(k); }
+		
+		/// \returns true if the key went up on any device in the group during the last update
+		bool was_released_this_frame(int group_id, key_type k) const { return get_group_state(group_id).was_released_this_frame(k); }
+		
+		/// \returns the last value of an axis on any device in the group
+		float axis_value(int group_id, axis_type a) const { return get_group_state(group_id).axis_value(a); }
+		//@}
+		
+		/// \name latency statistics
+		/// time in microseconds from an event being captured by its driver to the start of
+		/// the dispatch pass that hands its action to a handler, or to its batch for batched 
+		/// handlers. Events that don't map to an action aren't counted. Always empty when
+		/// built with TYCHO_INPUT_LATENCY_STATS set to 0.
+		//@{
+		/// \returns latencies of all events from devices of a type
+		latency_histogram get_device_latency(device_type type) const;
+		
+		/// \returns latencies of all events dispatched to a group
+		latency_histogram get_group_latency(int group_id) const;
+		
+		/// clear all latency statistics
+		void reset_latency_stats();
+		//@}
+		
+		/// \returns the number of events dropped because a driver's event ring overflowed
+		core::uint32 get_num_dropped_events() const;
+		
+		/// \returns the number of bytes used by a device group, binding sets are shared 
+		/// between groups and not included
+		size_t get_group_memory_usage(int group_id) const;
+		
+		/// \returns the number of input groups the interface was created with
+		int get_num_groups() const { return m_num_groups; }
+		
 		/// bind a device to an input group
 		/// \param device_id obtained from the device_description structure.
-		/// \param input_group group to bind to. Must be in range [0,7]
-		void bind_device(int input_group, int device_id);
+		/// \param input_group group to bind to. Must be in range [0,get_num_groups())
+		/// a device can only be bound to a single group, binding it again moves it.
+		/// bindings survive the device being unplugged and apply again when it returns.
+		/// \returns false if the group is out of range, the device's binding is unchanged.
+		bool bind_device(int input_group, int device_id);
+
+		/// remove a device from the group it is bound to.
+		void unbind_device(int device_id);
 	
 		/// find all available controllers
 		int enumerate_controllers(device_description const ** out_devices, int output_size) const;
@@ -72,59 +179,176 @@ namespace input
 				
 		/// register a set of bindings to use when it's corresponding actions are 
 		/// push on the stack. caller is responsible for the freeing the bindings.
+		/// The name must stay valid for the lifetime of the interface, same as action names.
 		void register_bindings(const char* name, const binding* bindings);
 		
+		/// register a null terminated set of combos pushed and popped with the action group
+		/// of the same name, alongside its bindings. Same lifetime rules as register_bindings.
+		void register_combos(const char* name, const combo* combos);
+		
+		/// override how mouse and axis events for an action are combined within an update.
+		/// by default this is picked from the action's requirements. Takes effect the next 
+		/// time a group containing the action is pushed. The name must stay valid for the 
+		/// lifetime of the interface, same as action names.
+		void set_coalesce_policy(const char* action_name, coalesce_policy policy);
+		
 		/// \name driver_base::event_handler interface
+		/// events fed in directly are dispatched immediately, coalesced actions are 
+		/// held until the next update() like those from drivers. With a job system set
+		/// events are instead queued on their group and handled by the next update().
 		//@{
 		virtual void handle_mouse_event(int device_id, const mouse_packet&);
 		virtual void handle_keyboard_event(int device_id, const keyboard_packet&);
 		virtual void handle_axis_event(int device_id, const axis_packet&);
+		virtual void handle_device_added(const device_description& desc);
+		virtual void handle_device_removed(int device_id);
 		//@}
 		
 	private:
 
     private:
+		/// actions collected for a handler that takes them in batches
+		struct handler_batch
+		{
+			input_handler*				handler;
+			std::vector<action_record>	records;	///< actions triggered this update
+			std::vector<action_record>	flushing;	///< swapped with records while the handler runs
+			int							num_refs;	///< pushed action groups using the batch
+		};
+		
 		/// information to dispatch a specific input event to user handler
 		struct action_handler
 		{
 			const action*  act;
 			input_handler* handler;			
+			coalesce_policy coalesce;	///< resolved policy, never coalesce_default
+			handler_batch* batch;		///< set if the handler takes batches
 		};
-
-		typedef core::scoped_hash_table<input, const char*, 123>	input_to_action_map;
-		typedef core::scoped_hash_table<const char*, action_handler, 123, &core::char_array_equals_fn>	action_to_handler_map;
-		typedef std::map<std::string, const binding*> binding_map;
+		
+		typedef scoped_index<action_handler>	action_to_handler_map;	///< interned action id to handler
+		
+		typedef std::vector<event_ring*> rings;
 		
 		/// group of devices mapped to a single group 
-		struct device_group :
-			public driver_base::event_handler
+		struct device_group
 		{	
 		public:
 			device_group();
 			void add_device(int device_id);
 			void remove_device(int device_id);
 			bool contains_device(int device_id);			
+			
+			/// \returns the devices bound to the group, unordered
+			const std::vector<int>& get_device_ids() const { return m_device_ids; }
 
-			/// map any input to its current handler
-			action_handler* map_input_to_action(const input& i);
+			/// map an input code to its current handler
+			action_handler* map_input_to_action(int input_code);
+			
+			/// map an input code to its current handler and the interned id of its action
+			action_handler* map_input_to_action(int input_code, int& action_id);
+			
+			/// dispatch all coalesced actions in the order they first arrived
+			void flush_pending();
+			
+			/// dispatch a packet from a device of the given type to the group's handlers
+			void dispatch(const event_packet& pkt, device_type type);
+			
+			/// hand an action to its handler, directly or through its batch
+			void dispatch_action(const action_handler& h, const action_record& r, device_type type);
+			
+			/// apply and dispatch every queued packet then flush coalesced actions
+			void run_queue();
+			
+			/// dispatch holds that have completed
+			void update_combos(core::int64 now);
+			
+			/// dispatch matched combos to their actions' handlers
+			void dispatch_combos(const combo_matcher::match* matches, int num_matches, device_type type);
+			
+			/// \returns the number of bytes used by the group
+			size_t get_memory_usage() const;
 
-			/// \name driver_base::event_handler interface
+			/// \name event dispatch
 			//@{
-			virtual void handle_mouse_event(int device_id, const mouse_packet&);
-			virtual void handle_keyboard_event(int device_id, const keyboard_packet&);
-			virtual void handle_axis_event(int device_id, const axis_packet&);
+			void handle_mouse_event(const event_packet& pkt, device_type type);
+			void handle_keyboard_event(const event_packet& pkt, device_type type);
+			void handle_axis_event(const event_packet& pkt, device_type type);
 			//@}
 			
-			input_to_action_map		m_input_map;
+			binding_layers			m_input_map;	///< input code to interned action id
+			combo_matcher			m_combos;		///< combos of the pushed action groups
 			action_to_handler_map	m_output_map;			
+			input_state				m_state;		///< combined state of all devices in the group, a key is
+													///< held while any of them holds it
+			bool					m_flush_queued;	///< group is in the interface's pending list
+			
+			/// \name parallel dispatch
+			//@{
+			/// packet routed to the group and the type of device it came from
+			struct queued_packet
+			{
+				event_packet	packet;
+				device_type		type;
+				bool			apply;	///< false if the group's state is left alone, see group_applies
+			};
+			
+			/// batched action produced while groups run in parallel
+			struct staged_record
+			{
+				handler_batch*	batch;
+				action_record	record;
+			};
+			
+			static const int ReservedQueue = 64;	///< initial size of the queue and staged records
+			
+			std::vector<queued_packet>	m_queue;			///< packets routed to the group this update
+			std::vector<staged_record>	m_staged;			///< batched actions waiting to be merged
+			bool						m_stage_batches;	///< stage batched actions as batches are shared
+			bool						m_active;			///< group is in the interface's active list
+			//@}
+			
+#if TYCHO_INPUT_LATENCY_STATS
+			latency_histogram*	m_latency;			///< per device type so groups can be run in parallel, in the interface's block
+			core::int64			m_dispatch_time;			///< time the current dispatch pass started
+#endif
+			
+			/// \returns true if there are coalesced actions waiting to be dispatched
+			bool has_pending() const { return !m_pending.empty(); }
 			
 		private:
 			/// non copyable
+			device_group(const device_group&);
 			void operator=(const device_group&);
+			
+			/// continuous input for an action held back until the end of the update
+			struct pending_action
+			{
+				action_handler	handler;
+				packet_type		ptype;
+				int				slot;		///< index into m_pending_slots
+				core::int64		timestamp;	///< capture time of the first event coalesced
+				device_type		type;		///< type of the device the first event came from
+				int				dx;
+				int				dy;
+				float			value;
+			};
+			typedef std::vector<pending_action> pending_actions;
+			
+			/// \returns the pending entry for an action and packet type, creating it if needed
+			pending_action& get_pending(int action_id, const action_handler& handler, const event_packet& pkt, device_type type);
+			
+			static const int ReservedPending = 16;
+			
+			pending_actions		m_pending;			///< in order of first arrival
+			pending_actions		m_flushing;			///< swapped with m_pending while flushing
+			std::vector<int>	m_pending_slots;	///< index into m_pending per action id and packet type, -1 if none
 
-			static const int MaxDevices = 8;
-			int m_device_ids[MaxDevices];
-			int m_num_devices;
+			static const int ReservedDevices = 4;
+			std::vector<int>	m_device_ids;	///< devices bound to the group, unordered
+			
+			// groups run on different threads so keep neighbours off each other's cache lines
+			static const int CacheLineSize = 64;
+			char m_pad[CacheLineSize];
 		};
 
 		/// non copyable
@@ -132,20 +356,166 @@ namespace input
 							
 		/// find the group a device is mapped to
 		device_group* get_device_group(int device_id);
+		
+		/// \returns true if a group id is in range
+		bool is_valid_group(int group_id) const { return (unsigned)group_id < (unsigned)m_num_groups; }
+		
+		/// position in a ring's acquired packets while the rings are merged
+		struct ring_cursor
+		{
+			event_ring*			ring;
+			const driver_base*	driver;		///< driver filling the ring
+			event_ring::span	spans[2];
+			int					num_spans;
+			int					span;		///< span holding the next packet
+			int					pos;		///< next packet in the span
+			int					count;		///< number of packets acquired
+			
+			/// \returns the next packet to dispatch
+			const event_packet& next() const { return spans[span].packets[pos]; }
+			
+			/// step to the following packet
+			/// \returns false once every acquired packet has been visited
+			bool advance()
+			{
+				if(++pos < spans[span].count)
+					return true;
+				pos = 0;
+				return ++span < num_spans;
+			}
+		};
+		
+		/// heap ordering putting the cursor with the earliest next packet on top, 
+		/// ties go to the driver added first.
+		struct cursor_later
+		{
+			const ring_cursor* cursors;
+			bool operator()(int a, int b) const
+			{
+				core::int64 ta = cursors[a].next().timestamp;
+				core::int64 tb = cursors[b].next().timestamp;
+				return ta > tb || (ta == tb && a > b);
+			}
+		};
+		
+		/// dispatch the pending packets of every driver's ring in timestamp order
+		void dispatch_rings();
+		
+		/// dispatch a single packet to the group its device is bound to
+		/// \param driver driver the packet came from, describes the devices it adds. 0 for
+		///			   events fed in directly, which never add devices.
+		void dispatch_packet(const event_packet& pkt, const driver_base* driver);
+		
+		/// run every group with queued packets as a job
+		void dispatch_groups();
+		
+		/// job entry point, runs a single active group
+		static void run_group_job(void* context, int index);
+		
+		/// run anything still queued for a group and merge its staged records
+		void finish_group(device_group* g);
+		
+		/// add a connected device to the device list
+		/// \param timestamp time the device arrived, for recordings
+		void add_device(const device_description& desc, core::int64 timestamp);
+		
+		/// remove a disconnected device from the device list
+		/// \param timestamp time the device was removed, for recordings
+		void remove_device(int device_id, core::int64 timestamp);
+		
+		/// apply a packet to a device or group state, queuing it for publishing
+		void apply_state(input_state& state, const event_packet& pkt);
+		
+		/// \returns false for a key going up or down on a device while another device in
+		///			 its group holds the key, to the group it stays held throughout.
+		bool group_applies(const device_group& g, const event_packet& pkt) const;
+		
+		/// \returns true if a device in the group other than device_id holds a key
+		bool held_by_other(const device_group& g, int device_id, int key) const;
+		
+		/// release the keys a device holds from its group's state when it leaves the
+		/// group, unless another device in the group holds them too.
+		void release_group_keys(int group, int device_id);
+		
+		/// publish all states modified this update
+		void publish_states();
+		
+		/// dispatch the coalesced actions of every group that has any
+		void flush_pending_actions();
+		
+		/// \returns the batch for a handler, creating it on first use
+		handler_batch* acquire_batch(input_handler* handler);
+		
+		/// drop a reference to a batch, flushing and freeing it once unused
+		void release_batch(handler_batch* batch);
+		
+		/// deliver a batch's records to its handler
+		void flush_batch(handler_batch* batch);
+		
+		/// \returns the coalescing policy to use for an action
+		coalesce_policy resolve_coalesce_policy(int action_id, const action* a) const;
 					
+		/// \returns the binding set registered under a name or 0
+		const binding_set* find_bindings(const char* name) const;
+		
+		/// \returns the combo set registered under a name or 0
+		const combo_set* find_combos(const char* name) const;
+		
+		/// complete holds in every group that has combos pushed
+		void update_combos();
+		
+		/// \returns a device state, reusing one freed by a removed device if possible
+		input_state* create_state();
+		
 		/// push a key binding group on the stack, these will get first crack at binding to actions.
-		/// caller is responsible for the freeing the bindings.
-		void push_bindings(int group_id, const binding* bindings);
+		void push_bindings(int group_id, const binding_set& bindings);
 		
 		/// pop a group of key bindings off the stack
-		void pop_bindings(int group_id, const binding* bindings);
+		void pop_bindings(int group_id, const binding_set& bindings);
 					
-		static const int MaxGroups = 8;
+		/// \name initial container sizes
+		/// enough for a typical game that they never grow, they still do if exceeded.
+		//@{
+		static const int ReservedDevices = 32;
+		static const int ReservedNames = 256;	///< actions and binding sets
+		static const int ReservedBatches = 16;
+		static const int ReservedDrivers = 16;
+		//@}
 						
 		drivers	m_drivers;		///< input drivers currently in use
+		rings	m_rings;		///< event ring per driver, parallel to m_drivers
+		std::vector<ring_cursor> m_cursors;	///< rings with packets to merge this update
+		std::vector<int> m_merge_heap;		///< indices into m_cursors, min heap on their next packet's timestamp
+		std::vector<input_state*> m_device_states;	///< polled state per device, parallel to m_devices
+		std::vector<input_state*> m_queued_states;	///< states that need publishing at the end of the update
+		std::vector<input_state*> m_publishing;		///< states being published, swapped with m_queued_states
+		std::vector<device_group*> m_pending_groups;	///< groups with coalesced actions to flush
+		std::vector<coalesce_policy> m_coalesce;	///< policy overrides per interned action id
+		std::vector<handler_batch*> m_batches;		///< batches of all handlers that want them
+		std::vector<handler_batch*> m_free_batches;	///< released batches kept for reuse
+		std::vector<input_state*> m_free_states;	///< states of removed devices kept for reuse
+		allocator&	m_alloc;		///< source of everything the interface creates
+		std::vector<device_group*> m_active_groups;	///< groups with queued packets to run in parallel
+		std::vector<device_group*> m_combo_groups;	///< groups with a combo set pushed
+		job_system* m_jobs;		///< optional job system for parallel dispatch
+#if TYCHO_INPUT_LATENCY_STATS
+		core::int64 m_dispatch_time;	///< time the current update started dispatching
+#endif
+		capture_thread m_capture;	///< optional thread polling the drivers
+		int		m_capture_rate;	///< rate the capture thread was started at
+		input_recorder m_recorder;	///< optional recording of all events
+		int		m_frame;		///< number of updates so far
 		devices	m_devices;		///< devices currently exposed by the drivers
-		device_group m_groups[MaxGroups];		///< device group mappings
-		binding_map  m_bindings;
+		device_group* m_groups;					///< device group mappings, contiguous from m_alloc
+		int			  m_num_groups;
+#if TYCHO_INPUT_LATENCY_STATS
+		latency_histogram* m_latency;			///< device_count histograms per group, kept apart as they're large and rarely touched
+#endif
+		device_router m_router;					///< device id to group routing
+		name_table	 m_binding_names;	///< binding set names interned to an index into m_binding_sets
+		std::vector<binding_set*> m_binding_sets;	///< registered binding sets
+		std::vector<combo_set*> m_combo_sets;		///< registered combo sets, indexed the same as the binding sets
+		name_table	 m_action_names;	///< action names interned to the ids used at dispatch
 		int			 m_cur_driver_id;
     };
 
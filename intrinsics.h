@@ -0,0 +1,75 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Sunday, 18 October 2026 01:37:26 PM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __INTRINSICS_H_D5B81E6F_47A2_4C39_8F0E_3A6C92D7B154_
+#define __INTRINSICS_H_D5B81E6F_47A2_4C39_8F0E_3A6C92D7B154_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+#include "core/debug/assert.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TYCHO_INPUT_SSE2 1
+#include <emmintrin.h>
+#else
+#define TYCHO_INPUT_SSE2 0
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/// for small hot functions the compiler won't inline on its own because they have several callers
+#if defined(_MSC_VER)
+#define TYCHO_INPUT_FORCEINLINE __forceinline
+#else
+#define TYCHO_INPUT_FORCEINLINE inline __attribute__((always_inline))
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+
+	/// \returns index of the lowest set bit, v must be non zero
+	inline int count_trailing_zeros(core::uint32 v)
+	{
+		TYCHO_ASSERT(v);
+#if defined(_MSC_VER)
+		unsigned long idx;
+		_BitScanForward(&idx, v);
+		return (int)idx;
+#else
+		return __builtin_ctz(v);
+#endif
+	}
+
+	/// \returns number of zero bits above the highest set bit, v must be non zero
+	inline int count_leading_zeros(core::uint32 v)
+	{
+		TYCHO_ASSERT(v);
+#if defined(_MSC_VER)
+		unsigned long idx;
+		_BitScanReverse(&idx, v);
+		return 31 - (int)idx;
+#else
+		return __builtin_clz(v);
+#endif
+	}
+
+} // end namespace
+} // end namespace
+
+#endif // __INTRINSICS_H_D5B81E6F_47A2_4C39_8F0E_3A6C92D7B154_
@@ -0,0 +1,125 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Sunday, 18 October 2026 06:40:31 PM
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "job_system.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+namespace tycho
+{
+namespace input
+{
+
+	/// constructor
+	thread_pool::thread_pool(int num_workers) :
+		m_func(0),
+		m_context(0),
+		m_count(0),
+		m_remaining(0),
+		m_busy(0),
+		m_generation(0),
+		m_quit(false),
+		m_next(0)
+	{
+		for(int i = 0; i < num_workers; ++i)
+			m_threads.push_back(std::thread(&thread_pool::worker, this));
+	}
+	
+	/// destructor, waits for the workers to exit
+	thread_pool::~thread_pool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_quit = true;
+		}
+		m_start.notify_all();
+		for(size_t i = 0; i < m_threads.size(); ++i)
+			m_threads[i].join();
+	}
+	
+	/// run func(context, i) for every i in [0, count)
+	void thread_pool::run(job_func func, void* context, int count)
+	{
+		if(count <= 0)
+			return;
+		if(count == 1 || m_threads.empty())
+		{
+			for(int i = 0; i < count; ++i)
+				func(context, i);
+			return;
+		}
+		
+		{
+			// a worker that woke late for the last run may still be claiming from
+			// the old counter, wait for it before the counter is reset.
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_done.wait(lock, [this] { return m_busy == 0; });
+			m_func = func;
+			m_context = context;
+			m_count = count;
+			m_remaining = count;
+			m_next.store(0, std::memory_order_relaxed);
+			++m_generation;
+		}
+		m_start.notify_all();
+		
+		int done = execute(func, context, count);
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_remaining -= done;
+		m_done.wait(lock, [this] { return m_remaining == 0; });
+	}
+	
+	/// worker thread entry point
+	void thread_pool::worker()
+	{
+		unsigned seen = 0;
+		for(;;)
+		{
+			job_func func;
+			void* context;
+			int count;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_start.wait(lock, [this, seen] { return m_quit || m_generation != seen; });
+				if(m_quit)
+					return;
+				seen = m_generation;
+				func = m_func;
+				context = m_context;
+				count = m_count;
+				++m_busy;
+			}
+			int done = execute(func, context, count);
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_remaining -= done;
+				--m_busy;
+			}
+			m_done.notify_all();
+		}
+	}
+	
+	/// claim and run jobs until there are none left
+	int thread_pool::execute(job_func func, void* context, int count)
+	{
+		int done = 0;
+		for(;;)
+		{
+			int i = m_next.fetch_add(1, std::memory_order_relaxed);
+			if(i >= count)
+				break;
+			func(context, i);
+			++done;
+		}
+		return done;
+	}
+
+} // end namespace
+} // end namespace
@@ -0,0 +1,93 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Sunday, 18 October 2026 06:40:31 PM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __JOB_SYSTEM_H_7D3B91E4_0C6A_4F85_A2E7_5B18C4F96D20_
+#define __JOB_SYSTEM_H_7D3B91E4_0C6A_4F85_A2E7_5B18C4F96D20_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+
+	/// interface to a job system the input system can run work on. Games with 
+	/// their own scheduler implement this over it, thread_pool is a simple 
+	/// standalone implementation.
+	class TYCHO_INPUT_ABI job_system
+	{
+	public:
+		typedef void (*job_func)(void* context, int index);
+		
+		/// destructor
+		virtual ~job_system() {}
+		
+		/// run func(context, i) for every i in [0, count) and return once all of 
+		/// them have completed. The calling thread may run jobs itself.
+		virtual void run(job_func func, void* context, int count) = 0;
+	};
+	
+	/// fixed set of worker threads running jobs alongside the calling thread.
+	class TYCHO_INPUT_ABI thread_pool : public job_system
+	{
+	public:
+		/// constructor
+		/// \param num_workers number of threads in addition to the caller of run.
+		explicit thread_pool(int num_workers);
+		
+		/// destructor, waits for the workers to exit
+		virtual ~thread_pool();
+		
+		/// \name job_system interface
+		//@{
+		virtual void run(job_func func, void* context, int count);
+		//@}
+		
+	private:
+		/// non copyable
+		thread_pool(const thread_pool&);
+		void operator=(const thread_pool&);
+		
+		/// worker thread entry point
+		void worker();
+		
+		/// claim and run jobs until there are none left
+		/// \returns number of jobs run
+		int execute(job_func func, void* context, int count);
+		
+		std::vector<std::thread> m_threads;
+		std::mutex				m_mutex;
+		std::condition_variable m_start;		///< signalled when a run starts or on shutdown
+		std::condition_variable m_done;			///< signalled when a worker finishes its share
+		job_func				m_func;
+		void*					m_context;
+		int						m_count;
+		int						m_remaining;	///< jobs not yet completed
+		int						m_busy;			///< workers inside execute
+		unsigned				m_generation;	///< incremented every run
+		bool					m_quit;
+		std::atomic<int>		m_next;			///< next job index to claim
+	};
+
+} // end namespace
+} // end namespace
+
+#endif // __JOB_SYSTEM_H_7D3B91E4_0C6A_4F85_A2E7_5B18C4F96D20_
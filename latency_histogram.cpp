@@ -0,0 +1,97 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Sunday, 18 October 2026 09:42:17 AM
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "latency_histogram.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+namespace tycho
+{
+namespace input
+{
+
+	/// constructor
+	latency_histogram::latency_histogram()
+	{
+		reset();
+	}
+
+	/// add all samples from another histogram
+	void latency_histogram::merge(const latency_histogram& other)
+	{
+		if(!other.m_count)
+			return;
+		for(int i = 0; i < NumBuckets; ++i)
+			m_counts[i] += other.m_counts[i];
+		m_count += other.m_count;
+		m_total += other.m_total;
+		if(other.m_min < m_min)
+			m_min = other.m_min;
+		if(other.m_max > m_max)
+			m_max = other.m_max;
+	}
+
+	/// remove all samples
+	void latency_histogram::reset()
+	{
+		for(int i = 0; i < NumBuckets; ++i)
+			m_counts[i] = 0;
+		m_count = 0;
+		m_min = 0xffffffff;
+		m_max = 0;
+		m_total = 0;
+	}
+
+	/// \returns an upper bound on the given percentile
+	core::uint32 latency_histogram::get_percentile(double percentile) const
+	{
+		if(!m_count)
+			return 0;
+		// rank of the sample we want, 1 based so the 0th percentile is the smallest sample
+		core::uint64 rank = (core::uint64)(percentile / 100.0 * m_count + 0.5);
+		if(rank < 1)
+			rank = 1;
+		if(rank > m_count)
+			rank = m_count;
+		core::uint64 seen = 0;
+		for(int i = 0; i < NumBuckets; ++i)
+		{
+			seen += m_counts[i];
+			if(seen >= rank)
+			{
+				core::uint32 v = get_bucket_max(i);
+				return v < m_max ? v : m_max;
+			}
+		}
+		return m_max;
+	}
+
+	/// \returns the smallest value counted in a bucket
+	core::uint32 latency_histogram::get_bucket_min(int bucket)
+	{
+		if(bucket < SubBuckets)
+			return (core::uint32)bucket;
+		int shift = bucket / SubBuckets - 1;
+		return (core::uint32)(SubBuckets + bucket % SubBuckets) << shift;
+	}
+
+	/// \returns the largest value counted in a bucket, the last bucket also holds everything clamped into it
+	core::uint32 latency_histogram::get_bucket_max(int bucket)
+	{
+		if(bucket == NumBuckets - 1)
+			return 0xffffffff;
+		if(bucket < SubBuckets)
+			return (core::uint32)bucket;
+		int shift = bucket / SubBuckets - 1;
+		return get_bucket_min(bucket) + ((core::uint32)1 << shift) - 1;
+	}
+
+} // end namespace
+} // end namespace
@@ -0,0 +1,114 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Sunday, 18 October 2026 09:42:17 AM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __LATENCY_HISTOGRAM_H_6E2B9D41_C07A_4F58_93E1_B8D45A2F17C3_
+#define __LATENCY_HISTOGRAM_H_6E2B9D41_C07A_4F58_93E1_B8D45A2F17C3_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+#include "input/intrinsics.h"
+
+/// set to 0 to compile out latency measurement, the stats API then reports empty histograms.
+#ifndef TYCHO_INPUT_LATENCY_STATS
+#define TYCHO_INPUT_LATENCY_STATS 1
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+
+	/// fixed size log-linear histogram of latencies in microseconds. Each power of two
+	/// range is split into SubBuckets linear buckets so the error is bounded at 1/SubBuckets
+	/// of the value across the whole range. Recording is a few integer ops and never allocates,
+	/// values beyond the last bucket are clamped into it.
+	class TYCHO_INPUT_ABI latency_histogram
+	{
+	public:
+		static const int SubBucketBits = 3;
+		static const int SubBuckets = 1 << SubBucketBits;
+		static const int MaxExponent = 25;	///< last bucket covers values up to 2^26us, about a minute
+		static const int NumBuckets = (MaxExponent - SubBucketBits + 2) * SubBuckets;
+
+		/// constructor
+		latency_histogram();
+
+		/// add a sample
+		void record(core::uint32 us)
+		{
+			++m_counts[get_bucket(us)];
+			++m_count;
+			m_total += us;
+			if(us < m_min)
+				m_min = us;
+			if(us > m_max)
+				m_max = us;
+		}
+
+		/// add all samples from another histogram
+		void merge(const latency_histogram& other);
+
+		/// remove all samples
+		void reset();
+
+		/// \returns the number of samples
+		core::uint32 get_count() const { return m_count; }
+
+		/// \returns the smallest sample or 0 if empty
+		core::uint32 get_min() const { return m_count ? m_min : 0; }
+
+		/// \returns the largest sample or 0 if empty
+		core::uint32 get_max() const { return m_max; }
+
+		/// \returns the mean of all samples or 0 if empty
+		double get_mean() const { return m_count ? (double)m_total / m_count : 0.0; }
+
+		/// \returns an upper bound on the given percentile, in the range [0,100]. Exact to
+		/// within the width of the bucket the sample falls in and never above get_max().
+		core::uint32 get_percentile(double percentile) const;
+
+		/// \returns the number of samples in a bucket
+		core::uint32 get_bucket_count(int bucket) const { return m_counts[bucket]; }
+
+		/// \returns the bucket a value is counted in
+		static int get_bucket(core::uint32 us)
+		{
+			if(us < (core::uint32)SubBuckets)
+				return (int)us;
+			int exponent = 31 - count_leading_zeros(us);
+			if(exponent > MaxExponent)
+				return NumBuckets - 1;
+			int shift = exponent - SubBucketBits;
+			return (shift + 1) * SubBuckets + (int)((us >> shift) & (SubBuckets - 1));
+		}
+
+		/// \returns the smallest value counted in a bucket
+		static core::uint32 get_bucket_min(int bucket);
+
+		/// \returns the largest value counted in a bucket
+		static core::uint32 get_bucket_max(int bucket);
+
+	private:
+		core::uint32 m_counts[NumBuckets];
+		core::uint32 m_count;
+		core::uint32 m_min;
+		core::uint32 m_max;
+		core::uint64 m_total;
+	};
+
+} // end namespace
+} // end namespace
+
+#endif // __LATENCY_HISTOGRAM_H_6E2B9D41_C07A_4F58_93E1_B8D45A2F17C3_
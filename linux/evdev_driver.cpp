@@ -0,0 +1,446 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Sunday, 18 October 2026 09:20:33 AM
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "evdev_driver.h"
+#include "core/debug/assert.h"
+#include <linux/input.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+namespace tycho
+{
+namespace input
+{
+namespace lnx
+{
+
+	namespace detail
+	{
+		/// evdev key code to key_type lookup
+		struct key_map
+		{
+			key_map()
+			{
+				for(int i = 0; i < KEY_CNT; ++i)
+					keys[i] = key_invalid;
+				
+				static const int digits[] = { KEY_0, KEY_1, KEY_2, KEY_3, KEY_4, KEY_5, KEY_6, KEY_7, KEY_8, KEY_9 };
+				for(int i = 0; i < 10; ++i)
+					keys[digits[i]] = (key_type)(key_0 + i);
+				
+				static const int letters[] = { 
+					KEY_A, KEY_B, KEY_C, KEY_D, KEY_E, KEY_F, KEY_G, KEY_H, KEY_I, KEY_J, KEY_K, KEY_L, KEY_M, 
+					KEY_N, KEY_O, KEY_P, KEY_Q, KEY_R, KEY_S, KEY_T, KEY_U, KEY_V, KEY_W, KEY_X, KEY_Y, KEY_Z };
+				for(int i = 0; i < 26; ++i)
+					keys[letters[i]] = (key_type)(key_a + i);
+				
+				keys[KEY_LEFTALT] = key_win_lalt;
+				keys[KEY_RIGHTALT] = key_win_ralt;
+				keys[KEY_LEFTSHIFT] = key_shift;
+				keys[KEY_RIGHTSHIFT] = key_shift;
+				keys[KEY_LEFTCTRL] = key_control;
+				keys[KEY_RIGHTCTRL] = key_control;
+				keys[BTN_LEFT] = key_button_mouse_left;
+				keys[BTN_MIDDLE] = key_button_mouse_middle;
+				keys[BTN_RIGHT] = key_button_mouse_right;
+				keys[BTN_SOUTH] = key_button_a;
+				keys[BTN_EAST] = key_button_b;
+				keys[BTN_X] = key_button_x;
+				keys[BTN_Y] = key_button_y;
+				keys[BTN_TL] = key_button_left_shoulder;
+				keys[BTN_TR] = key_button_right_shoulder;
+				keys[BTN_SELECT] = key_button_back;
+				keys[BTN_START] = key_button_start;
+				keys[BTN_THUMBL] = key_button_left_thumb;
+				keys[BTN_THUMBR] = key_button_right_thumb;
+				keys[BTN_DPAD_UP] = key_button_dpad_up;
+				keys[BTN_DPAD_DOWN] = key_button_dpad_down;
+				keys[BTN_DPAD_LEFT] = key_button_dpad_left;
+				keys[BTN_DPAD_RIGHT] = key_button_dpad_right;
+			}
+			
+			key_type keys[KEY_CNT];
+		};
+		
+		const key_map g_key_map;
+		
+		/// \returns the axis an absolute axis code maps to
+		axis_type get_axis(int code)
+		{
+			switch(code)
+			{
+				case ABS_X:  return axis_lthumb_x;
+				case ABS_Y:  return axis_lthumb_y;
+				case ABS_RX: return axis_rthumb_x;
+				case ABS_RY: return axis_rthumb_y;
+				case ABS_Z:  return axis_ltrigger_x;
+				case ABS_RZ: return axis_rtrigger_x;
+				default: return axis_type_invalid;
+			}
+		}
+		
+		/// \returns absolute axis code for an axis
+		int get_abs_code(axis_type axis)
+		{
+			switch(axis)
+			{
+				case axis_lthumb_x:	  return ABS_X;
+				case axis_lthumb_y:	  return ABS_Y;
+				case axis_rthumb_x:	  return ABS_RX;
+				case axis_rthumb_y:	  return ABS_RY;
+				case axis_ltrigger_x: return ABS_Z;
+				case axis_rtrigger_x: return ABS_RZ;
+				default: return -1;
+			}
+		}
+		
+		bool is_trigger(axis_type axis)
+		{
+			return axis == axis_ltrigger_x || axis == axis_rtrigger_x;
+		}
+		
+		/// \returns true if bit is set in an evdev capability mask
+		bool test_bit(const unsigned long* bits, int bit)
+		{
+			const int BitsPerLong = sizeof(long) * 8;
+			return (bits[bit / BitsPerLong] >> (bit % BitsPerLong)) & 1;
+		}
+	}
+	
+	/// constructor
+	evdev_driver::evdev_driver() :
+		m_driver_id(0),
+		m_epoll_fd(-1),
+		m_initialised(false)
+	{
+	}
+	
+	/// destructor, closes all device fds
+	evdev_driver::~evdev_driver()
+	{
+		for(size_t i = 0; i < m_devices.size(); ++i)
+		{
+			close(m_devices[i]->fd);
+			delete m_devices[i];
+		}
+		m_devices.clear();
+		if(m_epoll_fd >= 0)
+			close(m_epoll_fd);
+	}
+	
+	/// open every /dev/input/event* style device in a directory
+	int evdev_driver::open_devices(const char* dir)
+	{
+		DIR* d = opendir(dir);
+		if(!d)
+			return 0;
+		
+		const int BitsPerLong = sizeof(long) * 8;
+		int num_opened = 0;
+		while(struct dirent* entry = readdir(d))
+		{
+			if(strncmp(entry->d_name, "event", 5) != 0)
+				continue;
+			char path[512];
+			snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+			int fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+			if(fd < 0)
+				continue;
+			
+			// classify from the device capabilities
+			unsigned long ev_bits[EV_CNT / BitsPerLong + 1];
+			unsigned long key_bits[KEY_CNT / BitsPerLong + 1];
+			memset(ev_bits, 0, sizeof(ev_bits));
+			memset(key_bits, 0, sizeof(key_bits));
+			ioctl(fd, EVIOCGBIT(0, sizeof(ev_bits)), ev_bits);
+			ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(key_bits)), key_bits);
+			device_type type = device_unknown;
+			if(detail::test_bit(ev_bits, EV_ABS) && detail::test_bit(key_bits, BTN_SOUTH))
+				type = device_gamepad;
+			else if(detail::test_bit(ev_bits, EV_REL) && detail::test_bit(key_bits, BTN_LEFT))
+				type = device_mouse;
+			else if(detail::test_bit(ev_bits, EV_KEY) && detail::test_bit(key_bits, KEY_A))
+				type = device_keyboard;
+			if(type == device_unknown)
+			{
+				close(fd);
+				continue;
+			}
+			
+			char name[128] = "Unknown evdev device";
+			ioctl(fd, EVIOCGNAME(sizeof(name) - 1), name);
+			if(add_device(fd, type, name))
+				++num_opened;
+		}
+		closedir(d);
+		return num_opened;
+	}
+	
+	/// add a device reading from an already open fd
+	bool evdev_driver::add_device(int fd, device_type type, const char* name)
+	{
+		TYCHO_ASSERT(!m_initialised);
+		if(fd < 0)
+			return false;
+		fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+		
+		device* d = new device();
+		memset(d, 0, sizeof(device));
+		d->fd = fd;
+		strncpy(d->name, name ? name : "", sizeof(d->name) - 1);
+		d->desc.type = type;
+		d->desc.name = d->name;
+		
+		// use the kernel's axis ranges if this is a real evdev device, otherwise
+		// assume the full 16 bit range for sticks and 8 bits for triggers.
+		for(int a = 0; a < axis_count; ++a)
+		{
+			abs_range& r = d->ranges[a];
+			bool trigger = detail::is_trigger((axis_type)a);
+			r.min = trigger ? 0 : -32768;
+			r.max = trigger ? 255 : 32767;
+			r.flat = 0;
+			int code = detail::get_abs_code((axis_type)a);
+			struct input_absinfo info;
+			if(code >= 0 && ioctl(fd, EVIOCGABS(code), &info) == 0 && info.maximum > info.minimum)
+			{
+				r.min = info.minimum;
+				r.max = info.maximum;
+				r.flat = info.flat;
+			}
+		}
+		m_devices.push_back(d);
+		return true;
+	}
+	
+	/// override the range of an absolute axis
+	bool evdev_driver::set_axis_range(int device, axis_type axis, int min, int max, int flat)
+	{
+		TYCHO_ASSERT(device >= 0 && device < (int)m_devices.size());
+		TYCHO_ASSERT(axis > axis_type_invalid && axis < axis_count && max > min);
+		if(device < 0 || device >= (int)m_devices.size() || axis <= axis_type_invalid || axis >= axis_count || max <= min)
+			return false;
+		abs_range& r = m_devices[device]->ranges[axis];
+		r.min = min;
+		r.max = max;
+		r.flat = flat;
+		return true;
+	}
+	
+	bool evdev_driver::initialise(int driver_id)
+	{
+		m_driver_id = driver_id;
+		m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+		if(m_epoll_fd < 0)
+			return false;
+		
+		for(size_t i = 0; i < m_devices.size(); ++i)
+		{
+			device* d = m_devices[i];
+			d->desc.id = make_device_id(driver_id, (int)i);
+			d->desc.index = (int)i;
+			
+			// regular files can't be polled, they are just read to the end every update
+			struct epoll_event ev;
+			ev.events = EPOLLIN;
+			ev.data.ptr = d;
+			d->pollable = epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, d->fd, &ev) == 0;
+		}
+		m_initialised = true;
+		return true;
+	}
+	
+	void evdev_driver::update(event_handler* handler)
+	{
+		struct epoll_event ready[MaxReadyPerPoll];
+		int num_ready;
+		do
+		{
+			num_ready = epoll_wait(m_epoll_fd, ready, MaxReadyPerPoll, 0);
+			for(int i = 0; i < num_ready; ++i)
+			{
+				device* d = (device*)ready[i].data.ptr;
+				drain(*d, handler);
+				if(d->eof)
+					epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, d->fd, 0);
+			}
+		}
+		while(num_ready == MaxReadyPerPoll);
+		
+		for(size_t i = 0; i < m_devices.size(); ++i)
+		{
+			device* d = m_devices[i];
+			if(!d->pollable && !d->eof)
+				drain(*d, handler);
+		}
+	}
+	
+	int evdev_driver::get_num_devices() const
+	{
+		return (int)m_devices.size();
+	}
+	
+	const device_description* evdev_driver::get_device_desc(int i) const
+	{
+		return &m_devices[i]->desc;
+	}
+	
+	/// read all pending events from a device. Writers are expected to write whole 
+	/// input_event records as the kernel does.
+	void evdev_driver::drain(device& d, event_handler* handler)
+	{
+		struct input_event events[MaxEventsPerRead];
+		for(;;)
+		{
+			ssize_t bytes = read(d.fd, events, sizeof(events));
+			if(bytes < 0)
+			{
+				if(errno == EINTR)
+					continue;
+				if(errno != EAGAIN)
+					d.eof = true;
+				return;
+			}
+			if(bytes == 0)
+			{
+				d.eof = true;
+				return;
+			}
+			int count = (int)(bytes / sizeof(struct input_event));
+			for(int i = 0; i < count; ++i)
+				translate(d, events[i], handler);
+			if(bytes < (ssize_t)sizeof(events))
+				return;
+		}
+	}
+	
+	/// translate a single event
+	void evdev_driver::translate(device& d, const struct input_event& ev, event_handler* handler)
+	{
+		if(ev.type == EV_SYN)
+		{
+			if(ev.code == SYN_DROPPED)
+			{
+				// the kernel buffer overflowed, everything up to the next report is unreliable
+				d.dropping = true;
+			}
+			else if(ev.code == SYN_REPORT)
+			{
+				if(!d.dropping && (d.rel_x || d.rel_y))
+					handler->handle_mouse_event(d.desc.id, make_mouse_packet(d.rel_x, d.rel_y));
+				d.rel_x = d.rel_y = 0;
+				d.dropping = false;
+			}
+			return;
+		}
+		if(d.dropping)
+			return;
+		
+		switch(ev.type)
+		{
+			case EV_KEY:
+			{
+				// ignore auto repeat
+				if(ev.code >= KEY_CNT || ev.value == 2)
+					return;
+				key_type key = detail::g_key_map.keys[ev.code];
+				if(key != key_invalid)
+					handler->handle_keyboard_event(d.desc.id, make_keyboard_packet(key, ev.value ? key_state_down : key_state_up));
+				break;
+			}
+			case EV_REL:
+			{
+				// motion is accumulated and sent as a single packet on the next sync
+				if(ev.code == REL_X)
+					d.rel_x += ev.value;
+				else if(ev.code == REL_Y)
+					d.rel_y += ev.value;
+				break;
+			}
+			case EV_ABS:
+			{
+				if(ev.code == ABS_HAT0X)
+				{
+					translate_hat(d, &d.hat_x, ev.value, key_button_dpad_left, key_button_dpad_right, handler);
+					return;
+				}
+				if(ev.code == ABS_HAT0Y)
+				{
+					translate_hat(d, &d.hat_y, ev.value, key_button_dpad_up, key_button_dpad_down, handler);
+					return;
+				}
+				axis_type axis = detail::get_axis(ev.code);
+				if(axis == axis_type_invalid)
+					return;
+				float value = normalise(d.ranges[axis], detail::is_trigger(axis), ev.value);
+				
+				// evdev y axes point down, ours point up like xinput
+				if(axis == axis_lthumb_y || axis == axis_rthumb_y)
+					value = -value;
+				handler->handle_axis_event(d.desc.id, make_axis_packet(axis, value));
+				break;
+			}
+		}
+	}
+	
+	/// translate a d-pad hat axis into key events
+	void evdev_driver::translate_hat(device& d, int* cur, int value, key_type neg, key_type pos, event_handler* handler)
+	{
+		if(value == *cur)
+			return;
+		if(*cur < 0)
+			handler->handle_keyboard_event(d.desc.id, make_keyboard_packet(neg, key_state_up));
+		else if(*cur > 0)
+			handler->handle_keyboard_event(d.desc.id, make_keyboard_packet(pos, key_state_up));
+		if(value < 0)
+			handler->handle_keyboard_event(d.desc.id, make_keyboard_packet(neg, key_state_down));
+		else if(value > 0)
+			handler->handle_keyboard_event(d.desc.id, make_keyboard_packet(pos, key_state_down));
+		*cur = value;
+	}
+	
+	/// \returns normalised value of an absolute axis, sticks map to [-1,1] around the middle
+	/// of their range and triggers map to [0,1] with the flat region treated as a deadzone.
+	/// Which is which goes by the axis, many pads report sticks as 0..255 or 0..65535.
+	float evdev_driver::normalise(const abs_range& r, bool trigger, int value)
+	{
+		if(trigger)
+		{
+			float range = (float)(r.max - r.min - r.flat);
+			float v = (float)(value - r.min - r.flat);
+			if(v <= 0)
+				return 0;
+			return v >= range ? 1.0f : v / range;
+		}
+		
+		float centre = (r.min + r.max) * 0.5f;
+		float half = (r.max - r.min) * 0.5f - r.flat;
+		float v = value - centre;
+		if(v > r.flat)
+			v -= r.flat;
+		else if(v < -r.flat)
+			v += r.flat;
+		else
+			return 0;
+		v /= half;
+		return v > 1.0f ? 1.0f : (v < -1.0f ? -1.0f : v);
+	}
+
+} // end namespace
+} // end namespace
+} // end namespace
@@ -0,0 +1,125 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Sunday, 18 October 2026 09:20:33 AM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __EVDEV_DRIVER_H_8A3F5D21_C96E_4B07_BD48_0E7C2A91F5D3_
+#define __EVDEV_DRIVER_H_8A3F5D21_C96E_4B07_BD48_0E7C2A91F5D3_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+#include "input/driver_base.h"
+#include <vector>
+
+struct input_event;
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+namespace lnx
+{
+
+	/// Linux evdev driver. Each device is a file descriptor producing struct input_event
+	/// records, normally /dev/input/event*, but any fd producing the same records works
+	/// (pipes, recorded event files) so the driver can be run without real hardware.
+	/// Pollable fds are multiplexed with epoll and every ready device is drained with
+	/// non blocking reads of many events per call.
+	class TYCHO_INPUT_ABI evdev_driver : public driver_base
+	{
+	public:
+		/// constructor
+		evdev_driver();
+
+		/// destructor, closes all device fds
+		virtual ~evdev_driver();
+
+		/// open every /dev/input/event* style device in a directory that can be 
+		/// classified as a keyboard, mouse or gamepad. 
+		/// \returns number of devices opened
+		int open_devices(const char* dir = "/dev/input");
+
+		/// add a device reading from an already open fd, the driver takes ownership of it.
+		/// must be called before the driver is added to the interface.
+		/// \param type kind of device reported in its description.
+		/// \param name user friendly name, this is copied.
+		bool add_device(int fd, device_type type, const char* name);
+
+		/// override the range of an absolute axis, for fds that aren't real evdev devices
+		/// and so can't report it, e.g. a recording of a pad with 8 bit sticks.
+		/// \param device index of the device in the order it was added.
+		/// \returns false if there is no such device or the range is empty
+		bool set_axis_range(int device, axis_type axis, int min, int max, int flat = 0);
+
+		/// \name driver_base interface
+		//@{
+		virtual bool initialise(int driver_id);
+		virtual void update(event_handler *);
+		virtual int get_num_devices() const;
+		virtual const device_description* get_device_desc(int i) const;
+		//@}
+
+	private:
+		/// non copyable
+		evdev_driver(const evdev_driver&);
+		void operator=(const evdev_driver&);
+
+		/// range of an absolute axis as reported by the kernel
+		struct abs_range
+		{
+			int min;
+			int max;
+			int flat;	///< deadzone around the centre
+		};
+
+		struct device
+		{
+			int					fd;
+			device_description	desc;
+			char				name[128];
+			abs_range			ranges[axis_count];	///< range of each mapped absolute axis
+			int					rel_x;		///< relative motion accumulated since the last sync
+			int					rel_y;
+			int					hat_x;		///< last d-pad hat state
+			int					hat_y;
+			bool				dropping;	///< kernel dropped events, ignore until the next sync
+			bool				pollable;	///< fd can be used with epoll
+			bool				eof;		///< fd has been closed by the writer
+		};
+
+		/// read all pending events from a device
+		void drain(device& d, event_handler* handler);
+
+		/// translate a single event
+		void translate(device& d, const struct input_event& ev, event_handler* handler);
+
+		/// translate a d-pad hat axis into key events
+		void translate_hat(device& d, int* cur, int value, key_type neg, key_type pos, event_handler* handler);
+
+		/// \returns normalised value of an absolute axis
+		static float normalise(const abs_range& r, bool trigger, int value);
+
+		static const int MaxEventsPerRead = 64;
+		static const int MaxReadyPerPoll = 16;
+
+		std::vector<device*> m_devices;
+		int	m_driver_id;
+		int	m_epoll_fd;
+		bool m_initialised;
+	};
+
+} // end namespace
+} // end namespace
+} // end namespace
+
+#endif // __EVDEV_DRIVER_H_8A3F5D21_C96E_4B07_BD48_0E7C2A91F5D3_
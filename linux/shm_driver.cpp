@@ -0,0 +1,165 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Monday, 19 October 2026 07:41:09 PM
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "shm_driver.h"
+#include "core/debug/assert.h"
+#include <errno.h>
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+namespace tycho
+{
+namespace input
+{
+namespace lnx
+{
+
+	/// constructor
+	shm_driver::shm_driver(const char* name, const device_config* devices, int num_devices, int capacity) :
+		m_name(name, name + strlen(name) + 1),
+		m_capacity(2),
+		m_header(0),
+		m_events(0),
+		m_tail(0),
+		m_num_invalid(0)
+	{
+		while(m_capacity < (core::uint32)capacity)
+			m_capacity *= 2;
+		TYCHO_ASSERT(num_devices <= TYI_SHM_MAX_DEVICES);
+		if(num_devices > TYI_SHM_MAX_DEVICES)
+			num_devices = TYI_SHM_MAX_DEVICES;
+		m_devices.resize(num_devices);
+		for(int i = 0; i < num_devices; ++i)
+		{
+			device& d = m_devices[i];
+			strncpy(d.name, devices[i].name ? devices[i].name : "", TYI_SHM_MAX_NAME - 1);
+			d.name[TYI_SHM_MAX_NAME - 1] = 0;
+			d.desc.id = 0;
+			d.desc.type = devices[i].type;
+			d.desc.name = d.name;
+			d.desc.index = i;
+		}
+	}
+
+	/// destructor, removes the ring
+	shm_driver::~shm_driver()
+	{
+		if(!m_header)
+			return;
+		munmap(m_header, tyi_shm_size(m_capacity));
+		shm_unlink(&m_name[0]);
+	}
+
+	/// create the ring
+	bool shm_driver::initialise(int driver_id)
+	{
+		TYCHO_ASSERT(!m_header);
+		for(size_t i = 0; i < m_devices.size(); ++i)
+			m_devices[i].desc.id = make_device_id(driver_id, (int)i);
+
+		// a ring left behind by a game that didn't exit cleanly is replaced
+		const char* name = &m_name[0];
+		int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+		if(fd < 0 && errno == EEXIST)
+		{
+			shm_unlink(name);
+			fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+		}
+		if(fd < 0)
+			return false;
+		size_t size = tyi_shm_size(m_capacity);
+		void* p = MAP_FAILED;
+		if(ftruncate(fd, (off_t)size) == 0)
+			p = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close(fd);
+		if(p == MAP_FAILED)
+		{
+			shm_unlink(name);
+			return false;
+		}
+
+		// the new object is zero filled, writers can't attach until the magic is set
+		m_header = (tyi_shm_header*)p;
+		m_events = tyi_shm_events(m_header);
+		m_header->version = TYI_SHM_VERSION;
+		m_header->capacity = m_capacity;
+		m_header->num_devices = (core::uint32)m_devices.size();
+		for(size_t i = 0; i < m_devices.size(); ++i)
+		{
+			m_header->devices[i].type = m_devices[i].desc.type;
+			memcpy(m_header->devices[i].name, m_devices[i].name, TYI_SHM_MAX_NAME);
+		}
+		for(core::uint32 i = 0; i < m_capacity; ++i)
+			m_events[i].seq = i;
+		__atomic_store_n(&m_header->magic, TYI_SHM_MAGIC, __ATOMIC_RELEASE);
+		return true;
+	}
+
+	/// issue every published event. At most one lap of the ring is read so writers
+	/// that keep up with us can't hold the update forever.
+	void shm_driver::update(event_handler* handler)
+	{
+		if(!m_header)
+			return;
+		core::uint32 mask = m_capacity - 1;
+		for(core::uint32 n = 0; n < m_capacity; ++n)
+		{
+			tyi_shm_event* slot = &m_events[m_tail & mask];
+			if(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != m_tail + 1)
+				break;
+			tyi_shm_event e = *slot;
+			__atomic_store_n(&slot->seq, m_tail + m_capacity, __ATOMIC_RELEASE);
+			++m_tail;
+
+			// writers are other processes, check everything before passing it on
+			if(e.device >= m_devices.size())
+			{
+				++m_num_invalid;
+				continue;
+			}
+			int device_id = m_devices[e.device].desc.id;
+			switch(e.kind)
+			{
+				case TYI_SHM_KEY:
+					if(e.code <= key_invalid || e.code >= key_count || e.state <= key_state_invalid || e.state >= key_state_count)
+						++m_num_invalid;
+					else
+						handler->handle_keyboard_event(device_id, make_keyboard_packet((key_type)e.code, (key_state)e.state));
+					break;
+				case TYI_SHM_MOUSE:
+					handler->handle_mouse_event(device_id, make_mouse_packet(e.x, e.y));
+					break;
+				case TYI_SHM_AXIS:
+				{
+					float value;
+					memcpy(&value, &e.x, sizeof(value));
+					if(e.code <= axis_type_invalid || e.code >= axis_count || value != value)
+						++m_num_invalid;
+					else
+						handler->handle_axis_event(device_id, make_axis_packet((axis_type)e.code, value));
+					break;
+				}
+				default:
+					++m_num_invalid;
+					break;
+			}
+		}
+	}
+
+	/// \returns the number of events writers dropped because the ring was full
+	core::uint32 shm_driver::get_num_dropped() const
+	{
+		return m_header ? __atomic_load_n(&m_header->num_dropped, __ATOMIC_RELAXED) : 0;
+	}
+
+} // end namespace
+} // end namespace
+} // end namespace
@@ -0,0 +1,96 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Monday, 19 October 2026 07:41:09 PM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __SHM_DRIVER_H_E5A18F30_2C97_4B6D_9F04_7D3B6E1C28A5_
+#define __SHM_DRIVER_H_E5A18F30_2C97_4B6D_9F04_7D3B6E1C28A5_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+#include "input/driver_base.h"
+#include "input/linux/shm_input.h"
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+namespace lnx
+{
+
+	/// driver for input injected by other processes, e.g. test harnesses, bots and
+	/// accessibility tools. It exposes a fixed set of virtual devices and creates a
+	/// POSIX shared memory ring that any number of processes write events for them
+	/// into using the C client in shm_input.h. update() drains the ring without
+	/// making any system calls.
+	class TYCHO_INPUT_ABI shm_driver : public driver_base
+	{
+	public:
+		/// virtual device to expose
+		struct device_config
+		{
+			device_type type;
+			const char* name;	///< copied, truncated to TYI_SHM_MAX_NAME - 1 characters
+		};
+
+		static const int DefaultCapacity = 4096;
+
+		/// constructor, the ring is created by initialise.
+		/// \param name shared memory object name, a leading / followed by no more slashes.
+		/// \param capacity number of event slots, rounded up to a power of 2.
+		shm_driver(const char* name, const device_config* devices, int num_devices, int capacity = DefaultCapacity);
+
+		/// destructor, removes the ring. Writers still attached keep their mapping
+		/// but nothing reads it any more.
+		virtual ~shm_driver();
+
+		/// \name driver_base interface
+		//@{
+		virtual bool initialise(int driver_id);
+		virtual void update(event_handler *);
+		virtual int get_num_devices() const { return (int)m_devices.size(); }
+		virtual const device_description* get_device_desc(int i) const { return &m_devices[i].desc; }
+		//@}
+
+		/// \returns the number of events writers dropped because the ring was full
+		core::uint32 get_num_dropped() const;
+
+		/// \returns the number of events thrown away because they were malformed
+		core::uint32 get_num_invalid() const { return m_num_invalid; }
+
+	private:
+		/// non copyable
+		shm_driver(const shm_driver&);
+		void operator=(const shm_driver&);
+
+		struct device
+		{
+			device_description	desc;
+			char				name[TYI_SHM_MAX_NAME];
+		};
+
+		std::vector<char>		m_name;			///< shared memory object name
+		std::vector<device>		m_devices;
+		core::uint32			m_capacity;
+		tyi_shm_header*			m_header;
+		tyi_shm_event*			m_events;
+		core::uint32			m_tail;			///< next slot to read
+		core::uint32			m_num_invalid;
+	};
+
+} // end namespace
+} // end namespace
+} // end namespace
+
+#endif // __SHM_DRIVER_H_E5A18F30_2C97_4B6D_9F04_7D3B6E1C28A5_
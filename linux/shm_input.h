@@ -0,0 +1,204 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Monday, 19 October 2026 07:41:09 PM
+//////////////////////////////////////////////////////////////////////////////
+#ifndef __SHM_INPUT_H_0C7E4A92_6B15_4D3F_A8E1_93F2B5D06C47_
+#define __SHM_INPUT_H_0C7E4A92_6B15_4D3F_A8E1_93F2B5D06C47_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+/// \name shared memory input
+/// layout of the shared memory ring read by lnx::shm_driver along with the C client
+/// used by other processes to write into it. This header is plain C so test
+/// harnesses, bots and tools don't need the rest of the library.
+///
+/// The game creates the ring, a header describing its virtual devices followed by
+/// a power of 2 number of event slots. Writers claim a slot by advancing head with
+/// a compare and swap, fill it in and publish it by setting its sequence number,
+/// the game reads slots in order until it finds one that isn't published yet. Once
+/// attached nothing on either side makes a system call. A writer that dies between
+/// claiming and publishing a slot stalls the ring until the game recreates it.
+///
+/// Writers need a compiler with the gcc __atomic builtins, strict C modes also need
+/// _POSIX_C_SOURCE 200809L for shm_open.
+//@{
+
+#define TYI_SHM_MAGIC		0x4d485354u	/* 'TSHM' */
+#define TYI_SHM_VERSION		1
+#define TYI_SHM_MAX_DEVICES	16
+#define TYI_SHM_MAX_NAME	60
+
+/// event kinds
+enum
+{
+	TYI_SHM_KEY = 0,	///< code is a tycho::input::key_type, state a key_state
+	TYI_SHM_MOUSE,		///< x and y are the deltas
+	TYI_SHM_AXIS		///< code is a tycho::input::axis_type, x holds the bits of a float value
+};
+
+/// event slot
+typedef struct tyi_shm_event
+{
+	uint32_t	seq;		///< slot is published when this is one more than its position
+	uint8_t		kind;
+	uint8_t		device;		///< index of the virtual device
+	uint8_t		code;
+	uint8_t		state;
+	int32_t		x;
+	int32_t		y;
+} tyi_shm_event;
+
+/// virtual device
+typedef struct tyi_shm_device
+{
+	uint32_t	type;		///< tycho::input::device_type
+	char		name[TYI_SHM_MAX_NAME];
+} tyi_shm_device;
+
+/// start of the shared memory, the event slots follow it
+typedef struct tyi_shm_header
+{
+	uint32_t		magic;			///< set last once the ring is ready
+	uint32_t		version;
+	uint32_t		capacity;		///< number of event slots
+	uint32_t		num_devices;
+	uint32_t		num_dropped;	///< events thrown away by writers because the ring was full
+	uint32_t		reserved[11];
+	tyi_shm_device	devices[TYI_SHM_MAX_DEVICES];
+	uint32_t		head;			///< next slot to claim, on a cache line of its own
+	uint32_t		pad[15];
+} tyi_shm_header;
+//@}
+
+/// \returns the event slots
+static inline tyi_shm_event* tyi_shm_events(tyi_shm_header* h)
+{
+	return (tyi_shm_event*)(h + 1);
+}
+
+/// \returns size of the shared memory for a ring
+static inline size_t tyi_shm_size(uint32_t capacity)
+{
+	return sizeof(tyi_shm_header) + (size_t)capacity * sizeof(tyi_shm_event);
+}
+
+/// map a ring created by the game
+/// \param name shared memory object name the game was given, e.g. "/mygame_input"
+/// \returns the ring or NULL if it doesn't exist or isn't ready
+static inline tyi_shm_header* tyi_shm_attach(const char* name)
+{
+	int fd = shm_open(name, O_RDWR, 0);
+	if(fd < 0)
+		return NULL;
+	struct stat st;
+	if(fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(tyi_shm_header))
+	{
+		close(fd);
+		return NULL;
+	}
+	void* p = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if(p == MAP_FAILED)
+		return NULL;
+	tyi_shm_header* h = (tyi_shm_header*)p;
+	uint32_t capacity = h->capacity;
+	if(__atomic_load_n(&h->magic, __ATOMIC_ACQUIRE) != TYI_SHM_MAGIC || h->version != TYI_SHM_VERSION ||
+	   capacity == 0 || (capacity & (capacity - 1)) != 0 || tyi_shm_size(capacity) > (size_t)st.st_size)
+	{
+		munmap(p, (size_t)st.st_size);
+		return NULL;
+	}
+	return h;
+}
+
+/// unmap a ring
+static inline void tyi_shm_detach(tyi_shm_header* h)
+{
+	if(h)
+		munmap(h, tyi_shm_size(h->capacity));
+}
+
+/// \returns index of the virtual device with a name or -1
+static inline int tyi_shm_find_device(const tyi_shm_header* h, const char* name)
+{
+	for(uint32_t i = 0; i < h->num_devices && i < TYI_SHM_MAX_DEVICES; ++i)
+	{
+		if(strncmp(h->devices[i].name, name, TYI_SHM_MAX_NAME) == 0)
+			return (int)i;
+	}
+	return -1;
+}
+
+/// write an event, safe to call from any number of threads and processes at once
+/// \returns 1 if the event was queued, 0 if the ring was full and it was dropped
+static inline int tyi_shm_push(tyi_shm_header* h, int kind, int device, int code, int state, int32_t x, int32_t y)
+{
+	tyi_shm_event* events = tyi_shm_events(h);
+	uint32_t mask = h->capacity - 1;
+	uint32_t pos = __atomic_load_n(&h->head, __ATOMIC_RELAXED);
+	for(;;)
+	{
+		tyi_shm_event* e = &events[pos & mask];
+		uint32_t seq = __atomic_load_n(&e->seq, __ATOMIC_ACQUIRE);
+		int32_t diff = (int32_t)(seq - pos);
+		if(diff == 0)
+		{
+			// on failure pos is reloaded with the current head
+			if(__atomic_compare_exchange_n(&h->head, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			{
+				e->kind = (uint8_t)kind;
+				e->device = (uint8_t)device;
+				e->code = (uint8_t)code;
+				e->state = (uint8_t)state;
+				e->x = x;
+				e->y = y;
+				__atomic_store_n(&e->seq, pos + 1, __ATOMIC_RELEASE);
+				return 1;
+			}
+		}
+		else if(diff < 0)
+		{
+			// the slot from the previous lap hasn't been read yet
+			__atomic_fetch_add(&h->num_dropped, 1, __ATOMIC_RELAXED);
+			return 0;
+		}
+		else
+			pos = __atomic_load_n(&h->head, __ATOMIC_RELAXED);
+	}
+}
+
+/// write a key press or release
+static inline int tyi_shm_key(tyi_shm_header* h, int device, int key, int state)
+{
+	return tyi_shm_push(h, TYI_SHM_KEY, device, key, state, 0, 0);
+}
+
+/// write a mouse movement
+static inline int tyi_shm_mouse(tyi_shm_header* h, int device, int dx, int dy)
+{
+	return tyi_shm_push(h, TYI_SHM_MOUSE, device, 0, 0, dx, dy);
+}
+
+/// write an axis value
+static inline int tyi_shm_axis(tyi_shm_header* h, int device, int axis, float value)
+{
+	int32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return tyi_shm_push(h, TYI_SHM_AXIS, device, axis, 0, bits, 0);
+}
+
+#endif // __SHM_INPUT_H_0C7E4A92_6B15_4D3F_A8E1_93F2B5D06C47_
@@ -0,0 +1,244 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Saturday, 17 October 2026 03:48:30 PM
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "mapped_file.h"
+#if TYCHO_PC
+#include "core/pc/safe_windows.h"
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+namespace tycho
+{
+namespace input
+{
+
+	/// constructor
+	mapped_file::mapped_file() :
+		m_data(0),
+		m_size(0),
+		m_writable(false),
+#if TYCHO_PC
+		m_file(INVALID_HANDLE_VALUE),
+		m_mapping(0)
+#else
+		m_fd(-1)
+#endif
+	{
+	}
+	
+	/// destructor, closes the file
+	mapped_file::~mapped_file()
+	{
+		close();
+	}
+
+#if TYCHO_PC
+
+	/// map an existing file read only
+	bool mapped_file::open_read(const char* path)
+	{
+		close();
+		m_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+		if(m_file == INVALID_HANDLE_VALUE)
+			return false;
+		LARGE_INTEGER size;
+		if(!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+		{
+			close();
+			return false;
+		}
+		m_size = (size_t)size.QuadPart;
+		m_writable = false;
+		if(!map())
+		{
+			close();
+			return false;
+		}
+		return true;
+	}
+	
+	/// create (or truncate) a file and map it writable
+	bool mapped_file::open_write(const char* path, size_t size)
+	{
+		close();
+		m_file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, 0, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+		if(m_file == INVALID_HANDLE_VALUE)
+			return false;
+		m_writable = true;
+		if(!resize(size))
+		{
+			close();
+			return false;
+		}
+		return true;
+	}
+	
+	/// change the size of a writable mapping, the data pointer may change.
+	bool mapped_file::resize(size_t size)
+	{
+		TYCHO_ASSERT(m_writable);
+		unmap();
+		LARGE_INTEGER pos;
+		pos.QuadPart = (LONGLONG)size;
+		if(!SetFilePointerEx(m_file, pos, 0, FILE_BEGIN) || !SetEndOfFile(m_file))
+			return false;
+		m_size = size;
+		return size == 0 || map();
+	}
+	
+	/// \returns true if a file is open
+	bool mapped_file::is_open() const
+	{
+		return m_file != INVALID_HANDLE_VALUE;
+	}
+	
+	/// unmap and close the file
+	void mapped_file::close()
+	{
+		unmap();
+		if(m_file != INVALID_HANDLE_VALUE)
+			CloseHandle(m_file);
+		m_file = INVALID_HANDLE_VALUE;
+		m_size = 0;
+	}
+	
+	/// map the current file size
+	bool mapped_file::map()
+	{
+		m_mapping = CreateFileMappingA(m_file, 0, m_writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, 0);
+		if(!m_mapping)
+			return false;
+		m_data = (core::uint8*)MapViewOfFile(m_mapping, m_writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, m_size);
+		return m_data != 0;
+	}
+	
+	/// unmap the current view
+	void mapped_file::unmap()
+	{
+		if(m_data)
+			UnmapViewOfFile(m_data);
+		if(m_mapping)
+			CloseHandle(m_mapping);
+		m_data = 0;
+		m_mapping = 0;
+	}
+
+#else // TYCHO_PC
+
+	/// map an existing file read only
+	bool mapped_file::open_read(const char* path)
+	{
+		close();
+		m_fd = ::open(path, O_RDONLY);
+		if(m_fd < 0)
+			return false;
+		struct stat st;
+		if(fstat(m_fd, &st) != 0 || st.st_size == 0)
+		{
+			close();
+			return false;
+		}
+		m_size = (size_t)st.st_size;
+		m_writable = false;
+		if(!map())
+		{
+			close();
+			return false;
+		}
+		return true;
+	}
+	
+	/// create (or truncate) a file and map it writable
+	bool mapped_file::open_write(const char* path, size_t size)
+	{
+		close();
+		m_fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+		if(m_fd < 0)
+			return false;
+		m_writable = true;
+		if(!resize(size))
+		{
+			close();
+			return false;
+		}
+		return true;
+	}
+	
+	/// change the size of a writable mapping, the data pointer may change.
+	bool mapped_file::resize(size_t size)
+	{
+		TYCHO_ASSERT(m_writable);
+		unmap();
+		struct stat st;
+		if(fstat(m_fd, &st) != 0)
+			return false;
+		if((off_t)size > st.st_size)
+		{
+			// allocate the blocks now, ftruncate alone leaves a sparse file and a full
+			// disk then shows up as SIGBUS when the mapping is written instead of here.
+			// file systems that can't preallocate fall back to it anyway.
+			int err = posix_fallocate(m_fd, 0, (off_t)size);
+			if(err == EINVAL || err == EOPNOTSUPP)
+				err = ftruncate(m_fd, (off_t)size);
+			if(err != 0)
+				return false;
+		}
+		else if(ftruncate(m_fd, (off_t)size) != 0)
+			return false;
+		m_size = size;
+		return size == 0 || map();
+	}
+	
+	/// \returns true if a file is open
+	bool mapped_file::is_open() const
+	{
+		return m_fd >= 0;
+	}
+	
+	/// unmap and close the file
+	void mapped_file::close()
+	{
+		unmap();
+		if(m_fd >= 0)
+			::close(m_fd);
+		m_fd = -1;
+		m_size = 0;
+	}
+	
+	/// map the current file size
+	bool mapped_file::map()
+	{
+		int prot = m_writable ? PROT_READ | PROT_WRITE : PROT_READ;
+		void* p = mmap(0, m_size, prot, MAP_SHARED, m_fd, 0);
+		if(p == MAP_FAILED)
+			return false;
+		m_data = (core::uint8*)p;
+		return true;
+	}
+	
+	/// unmap the current view
+	void mapped_file::unmap()
+	{
+		if(m_data)
+			munmap(m_data, m_size);
+		m_data = 0;
+	}
+
+#endif // TYCHO_PC
+
+} // end namespace
+} // end namespace
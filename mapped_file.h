@@ -0,0 +1,89 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Saturday, 17 October 2026 03:48:30 PM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __MAPPED_FILE_H_19E6B7D4_0C5A_4F83_A2E9_8B4D3F7C1A65_
+#define __MAPPED_FILE_H_19E6B7D4_0C5A_4F83_A2E9_8B4D3F7C1A65_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+
+	/// file mapped into memory, either read only or writable and resizable.
+	class TYCHO_INPUT_ABI mapped_file
+	{
+	public:
+		/// constructor
+		mapped_file();
+
+		/// destructor, closes the file
+		~mapped_file();
+
+		/// map an existing file read only
+		bool open_read(const char* path);
+
+		/// create (or truncate) a file and map it writable
+		/// \param size initial size of the file in bytes
+		bool open_write(const char* path, size_t size);
+
+		/// change the size of a writable mapping, the data pointer may change. Growing the
+		/// file allocates its space so running out of disk fails here. On failure the file
+		/// is left open but unmapped, it can be resized again or closed.
+		bool resize(size_t size);
+
+		/// unmap and close the file
+		void close();
+
+		/// \returns start of the mapping
+		core::uint8* data() const { return m_data; }
+
+		/// \returns size of the mapping in bytes
+		size_t size() const { return m_size; }
+
+		/// \returns true if a file is open, it may not be mapped if a resize failed
+		bool is_open() const;
+
+		/// \returns true if a file is mapped
+		bool is_mapped() const { return m_data != 0; }
+
+	private:
+		/// non copyable
+		mapped_file(const mapped_file&);
+		void operator=(const mapped_file&);
+
+		/// map the current file size
+		bool map();
+
+		/// unmap the current view
+		void unmap();
+
+		core::uint8*	m_data;
+		size_t			m_size;
+		bool			m_writable;
+#if TYCHO_PC
+		void*			m_file;
+		void*			m_mapping;
+#else
+		int				m_fd;
+#endif
+	};
+
+} // end namespace
+} // end namespace
+
+#endif // __MAPPED_FILE_H_19E6B7D4_0C5A_4F83_A2E9_8B4D3F7C1A65_
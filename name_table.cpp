@@ -0,0 +1,115 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Saturday, 17 October 2026 02:21:09 PM
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "name_table.h"
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+namespace tycho
+{
+namespace input
+{
+
+	namespace detail
+	{
+		const int InitialSlots = 64;
+	}
+	
+	/// constructor
+	name_table::name_table(int num_names)
+	{
+		// keep the load factor under a half
+		size_t num_slots = detail::InitialSlots;
+		while(num_slots < (size_t)num_names * 2)
+			num_slots *= 2;
+		slot empty = { 0, -1 };
+		m_slots.resize(num_slots, empty);
+		m_names.reserve(num_names);
+	}
+	
+	/// \returns the id of the name, adding it if it has not been seen before.
+	int name_table::intern(const char* name)
+	{
+		TYCHO_ASSERT(name);
+		core::uint32 h = hash_name(name);
+		int s = find_slot(name, h);
+		if(m_slots[s].id >= 0)
+			return m_slots[s].id;
+		
+		// keep the load factor under a half
+		if((m_names.size() + 1) * 2 > m_slots.size())
+		{
+			grow();
+			s = find_slot(name, h);
+		}
+		int id = (int)m_names.size();
+		m_names.push_back(name);
+		m_slots[s].hash = h;
+		m_slots[s].id = id;
+		return id;
+	}
+	
+	/// \returns the id of the name or -1 if it has not been interned.
+	int name_table::find(const char* name) const
+	{
+		TYCHO_ASSERT(name);
+		return m_slots[find_slot(name, hash_name(name))].id;
+	}
+	
+	/// \returns the slot holding the name or the empty slot it should be inserted in
+	int name_table::find_slot(const char* name, core::uint32 hash) const
+	{
+		core::uint32 mask = (core::uint32)m_slots.size() - 1;
+		core::uint32 s = hash & mask;
+		for(;;)
+		{
+			const slot& cur = m_slots[s];
+			if(cur.id < 0)
+				return (int)s;
+			if(cur.hash == hash && strcmp(m_names[cur.id], name) == 0)
+				return (int)s;
+			s = (s + 1) & mask;
+		}
+	}
+	
+	/// double the size of the slot table and reinsert everything
+	void name_table::grow()
+	{
+		slot empty = { 0, -1 };
+		std::vector<slot> old;
+		old.swap(m_slots);
+		m_slots.resize(old.size() * 2, empty);
+		core::uint32 mask = (core::uint32)m_slots.size() - 1;
+		for(size_t i = 0; i < old.size(); ++i)
+		{
+			if(old[i].id < 0)
+				continue;
+			core::uint32 s = old[i].hash & mask;
+			while(m_slots[s].id >= 0)
+				s = (s + 1) & mask;
+			m_slots[s] = old[i];
+		}
+	}
+	
+	/// \returns string hash, FNV-1a
+	core::uint32 name_table::hash_name(const char* name)
+	{
+		core::uint32 h = 2166136261u;
+		for(; *name; ++name)
+		{
+			h ^= (unsigned char)*name;
+			h *= 16777619u;
+		}
+		return h;
+	}
+
+} // end namespace
+} // end namespace
@@ -0,0 +1,75 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Saturday, 17 October 2026 02:21:09 PM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __NAME_TABLE_H_C4D81F26_93A7_4B5E_8D02_7E1A5F9B36C3_
+#define __NAME_TABLE_H_C4D81F26_93A7_4B5E_8D02_7E1A5F9B36C3_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+
+	/// interns strings to small dense integer ids. Ids are allocated in order
+	/// starting at zero and never change for the lifetime of the table so they
+	/// can be used to index directly into per action tables. The table stores 
+	/// the pointers it is given, the caller is responsible for keeping the 
+	/// strings alive, same as bindings and actions.
+	class TYCHO_INPUT_ABI name_table
+	{
+	public:
+		/// constructor
+		/// \param num_names number of names to size the table for, it grows if more are interned.
+		explicit name_table(int num_names = 0);
+
+		/// \returns the id of the name, adding it if it has not been seen before.
+		int intern(const char* name);
+
+		/// \returns the id of the name or -1 if it has not been interned.
+		int find(const char* name) const;
+
+		/// \returns the name for an id
+		const char* get_name(int id) const { return m_names[id]; }
+
+		/// \returns the number of interned names, all ids are less than this.
+		int size() const { return (int)m_names.size(); }
+
+	private:
+		/// \returns the slot holding the name or the empty slot it should be inserted in
+		int find_slot(const char* name, core::uint32 hash) const;
+
+		/// double the size of the slot table and reinsert everything
+		void grow();
+
+		/// \returns string hash
+		static core::uint32 hash_name(const char* name);
+
+		struct slot
+		{
+			core::uint32 hash;
+			int			 id;	///< -1 when the slot is empty
+		};
+
+		std::vector<slot>			m_slots;	///< open addressed hash of name to id, always a power of 2 in size
+		std::vector<const char*>	m_names;	///< names indexed by id
+	};
+
+} // end namespace
+} // end namespace
+
+#endif // __NAME_TABLE_H_C4D81F26_93A7_4B5E_8D02_7E1A5F9B36C3_
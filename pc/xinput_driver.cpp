@@ -9,6 +9,7 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "xinput_driver.h"
 #include "input/types.h"
+#include "input/axis_normaliser.h"
 #include "core/memory.h"
 #include "core/debug/utilities.h"
 
@@ -27,27 +28,30 @@ namespace pc
 
 	namespace detail
 	{
-		float get_normalised_axis(int val, int deadzone)
+		/// \returns the platform neutral state of an xinput pad
+		gamepad_state to_gamepad_state(const XINPUT_GAMEPAD& pad)
 		{
-			// clamp to the deadzone and scale the remaining range into [0,1]
-			if(val >= 0 && val < deadzone)
-				val = 0;
-			else if(val < 0 && val >= -deadzone)
-				val = 0;
-			else if (val < 0)
-				val += deadzone;
-			else 
-				val -= deadzone;
-				
-			return ((float)val) / (32768 - deadzone);
+			gamepad_state s = make_gamepad_state();
+			s.buttons = pad.wButtons;
+			s.axes[gamepad_axis_lthumb_x] = pad.sThumbLX;
+			s.axes[gamepad_axis_lthumb_y] = pad.sThumbLY;
+			s.axes[gamepad_axis_rthumb_x] = pad.sThumbRX;
+			s.axes[gamepad_axis_rthumb_y] = pad.sThumbRY;
+			s.axes[gamepad_axis_ltrigger] = pad.bLeftTrigger;
+			s.axes[gamepad_axis_rtrigger] = pad.bRightTrigger;
+			return s;
 		}
 	}
 	
 	/// constructor
 	xinput_driver::xinput_driver() :
-		m_num_devices(0)
+		m_num_devices(0),
+		m_next_probe(0),
+		m_config(gamepad_config::make_default())
 	{
 		core::mem_zero(m_devices, sizeof(device) * MaxDevices);
+		for(int i = 0; i < MaxDevices; ++i)
+			m_devices[i].m_connected_index = -1;
 	}
 	
 	
@@ -68,100 +72,117 @@ namespace pc
 	/// called frequently to let the driver push any input events onto the input stream.
 	void xinput_driver::update(event_handler *handler)
 	{
-		for(int i = 0; i < MaxDevices; ++i)
+		// poll the connected pads first so the changed states can be normalised in one batch
+		gamepad_state cur[MaxDevices];
+		int changed[MaxDevices];
+		int lost[MaxDevices];
+		int num_changed = 0;
+		int num_lost = 0;
+		for(int c = 0; c < m_num_devices; ++c)
 		{
+			int i = m_connected[c];
 			device &d = m_devices[i];		
 			XINPUT_STATE state;
-			if(XInputGetState(i, &state) == ERROR_SUCCESS)
+			if(XInputGetState(i, &state) != ERROR_SUCCESS)
+				lost[num_lost++] = i;
+			else if(d.m_packet_num != (int)state.dwPacketNumber)
+			{
+				cur[num_changed] = detail::to_gamepad_state(state.Gamepad);
+				changed[num_changed++] = i;
+				d.m_packet_num = state.dwPacketNumber;
+			}				
+		}
+		
+		if(num_changed > 0)
+		{
+			float normalised[MaxDevices * gamepad_axis_count];
+			normalise_gamepad_axes(cur, num_changed, m_config, normalised);
+			
+			// compare each changed state to its last state and trigger any events
+			for(int i = 0; i < num_changed; ++i)
 			{
-				d.m_connected = true;
+				device &d = m_devices[changed[i]];
+				emit_gamepad_events(d.m_desc.id, d.m_state, cur[i], normalised + i * gamepad_axis_count, m_config, handler);
+				TYCHO_TRACE_INPUT(core::debug::write_ln("buttons : %x", cur[i].buttons));
 				
-				// don't generate any events for first update just store it.
-				if(d.m_packet_num == 0)
-				{
-					core::mem_cpy(&d.m_device.Gamepad, &state.Gamepad, sizeof(XINPUT_GAMEPAD));
-					d.m_packet_num = state.dwPacketNumber;				
-				}				
-				// compare this state to last state and trigger any events
-				else if(d.m_packet_num != (int)state.dwPacketNumber)
-				{
-					// check to see which button were down and now are up so we can generate a button up event
-					struct button_map
-					{
-						int xinput;
-						key_type tycho;
-					};
-					const button_map ButtonMasks[] = {
-						{ XINPUT_GAMEPAD_DPAD_UP, key_button_dpad_up },
-						{ XINPUT_GAMEPAD_DPAD_DOWN, key_button_dpad_down },
-						{ XINPUT_GAMEPAD_DPAD_LEFT, key_button_dpad_left },
-						{ XINPUT_GAMEPAD_DPAD_RIGHT, key_button_dpad_right },
-						{ XINPUT_GAMEPAD_START, key_button_start },
-						{ XINPUT_GAMEPAD_BACK, key_button_back },
-						{ XINPUT_GAMEPAD_LEFT_THUMB, key_button_left_thumb },
-						{ XINPUT_GAMEPAD_RIGHT_THUMB, key_button_right_thumb },
-						{ XINPUT_GAMEPAD_LEFT_SHOULDER, key_button_left_shoulder },
-						{ XINPUT_GAMEPAD_RIGHT_SHOULDER, key_button_right_shoulder },
-						{ XINPUT_GAMEPAD_A, key_button_a },
-						{ XINPUT_GAMEPAD_B, key_button_b },
-						{ XINPUT_GAMEPAD_X, key_button_x },
-						{ XINPUT_GAMEPAD_Y, key_button_y },
-						{ 0, key_invalid }};
-					
-					// check buttons
-					for(const button_map* m = ButtonMasks; m->xinput; ++m)
-					{
-						bool is_down = (state.Gamepad.wButtons & m->xinput) > 0;
-						bool was_down  = (d.m_device.Gamepad.wButtons & m->xinput) > 0;
-						
-						// if it wasn't down but is now generate a button press event
-						if(!was_down && is_down)
-						{
-							handler->handle_keyboard_event(d.m_desc.id, make_keyboard_packet(m->tycho, key_state_down));
-							TYCHO_TRACE_INPUT(core::debug::write_ln("button pressed : %d", m->tycho));
-						}
-						// if it was down and now isn't generate a button release event
-						else if(was_down && !is_down)
-						{
-							handler->handle_keyboard_event(d.m_desc.id, make_keyboard_packet(m->tycho, key_state_up));
-							TYCHO_TRACE_INPUT(core::debug::write_ln("button released : %d", m->tycho));
-						}
-					}
-					
-					// check sticks
-					if(d.m_device.Gamepad.sThumbLX != state.Gamepad.sThumbLX)					
-					{
-						float lthumb_x = detail::get_normalised_axis(state.Gamepad.sThumbLX, XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE);
-						handler->handle_axis_event(d.m_desc.id, make_axis_packet(axis_lthumb_x, lthumb_x));														
-					}
-					if(d.m_device.Gamepad.sThumbLY != state.Gamepad.sThumbLY)					
-					{
-						float lthumb_y = detail::get_normalised_axis(state.Gamepad.sThumbLY, XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE);
-						handler->handle_axis_event(d.m_desc.id, make_axis_packet(axis_lthumb_y, lthumb_y));														
-					}
-					if(d.m_device.Gamepad.sThumbRX != state.Gamepad.sThumbRX)					
-					{					
-						float rthumb_x = detail::get_normalised_axis(state.Gamepad.sThumbRX, XINPUT_GAMEPAD_RIGHT_THUMB_DEADZONE);
-						handler->handle_axis_event(d.m_desc.id, make_axis_packet(axis_rthumb_x, rthumb_x));														
-					}
-					if(d.m_device.Gamepad.sThumbRY != state.Gamepad.sThumbRY)					
-					{										
-						float rthumb_y = detail::get_normalised_axis(state.Gamepad.sThumbRY, XINPUT_GAMEPAD_RIGHT_THUMB_DEADZONE);														
-						handler->handle_axis_event(d.m_desc.id, make_axis_packet(axis_rthumb_y, rthumb_y));														
-					}
-					
-					// save current state
-					core::mem_cpy(&d.m_device.Gamepad, &state.Gamepad, sizeof(XINPUT_GAMEPAD));
-					d.m_packet_num = state.dwPacketNumber;
-				}				
+				// save current state
+				d.m_state = cur[i];
 			}
-			else
+		}
+		
+		for(int i = 0; i < num_lost; ++i)
+			disconnect(lost[i], handler);
+		probe(handler);
+	}
+	
+	/// start reporting the pad in a slot. The first state is stored without 
+	/// generating any events.
+	bool xinput_driver::connect(int slot)
+	{
+		device &d = m_devices[slot];
+		XINPUT_STATE state;
+		if(XInputGetState(slot, &state) != ERROR_SUCCESS)
+			return false;
+		XInputGetCapabilities(slot, XINPUT_FLAG_GAMEPAD, &d.m_device);
+		
+		// the description only depends on the slot so it never changes once set
+		d.m_desc.id = make_device_id(m_driver_id, slot);
+		d.m_desc.index = slot;
+		d.m_desc.name  = "XBox 360 Controller";
+		d.m_desc.type  = device_xenoncontroller;
+		d.m_state = detail::to_gamepad_state(state.Gamepad);
+		d.m_packet_num = state.dwPacketNumber;
+		d.m_connected_index = m_num_devices;
+		m_connected[m_num_devices++] = slot;
+		return true;
+	}
+	
+	/// stop reporting the pad in a slot, releasing anything it held
+	void xinput_driver::disconnect(int slot, event_handler* handler)
+	{
+		device &d = m_devices[slot];
+		TYCHO_ASSERT(d.m_connected_index >= 0);
+		
+		// return the pad to rest so no buttons are left held down
+		emit_gamepad_events(d.m_desc.id, d.m_state, make_gamepad_state(), m_config, handler);
+		
+		// move the last connected pad into the hole
+		int last = m_connected[--m_num_devices];
+		m_connected[d.m_connected_index] = last;
+		m_devices[last].m_connected_index = d.m_connected_index;
+		d.m_connected_index = -1;
+		handler->handle_device_removed(d.m_desc.id);
+	}
+	
+	/// check a single empty slot for a new pad. XInputGetState on an empty slot is
+	/// slow so the cost is spread over updates rather than checking them all at once.
+	void xinput_driver::probe(event_handler* handler)
+	{
+		for(int n = 0; n < MaxDevices; ++n)
+		{
+			int slot = m_next_probe;
+			m_next_probe = (m_next_probe + 1) % MaxDevices;
+			if(m_devices[slot].m_connected_index < 0)
 			{
-				d.m_connected = false;
+				if(connect(slot))
+					handler->handle_device_added(m_devices[slot].m_desc);
+				return;
 			}
 		}
 	}
 	
+	/// set the deadzones and deadzone mode used for all pads
+	void xinput_driver::set_gamepad_config(const gamepad_config& config)
+	{
+		m_config = config;
+	}
+	
+	/// \returns the deadzones and deadzone mode used for all pads
+	const gamepad_config& xinput_driver::get_gamepad_config() const
+	{
+		return m_config;
+	}
+	
 	/// \returns the number of devices available from this driver
 	int xinput_driver::get_num_devices() const
 	{
@@ -171,34 +192,29 @@ namespace pc
 	/// \returns the i'th device 
 	const device_description* xinput_driver::get_device_desc(int index) const
 	{
-		int num_connected = -1;
-		for(int i = 0; i < MaxDevices; ++i)
-		{
-			const device &d = m_devices[i];
-			if(d.m_connected)
-				++num_connected;
-			if(num_connected == index)
-				return &d.m_desc;
-		}
-		return 0;
+		if(index < 0 || index >= m_num_devices)
+			return 0;
+		return &m_devices[m_connected[index]].m_desc;
+	}
+	
+	/// \returns the description of a pad by id, descriptions are kept for pads that
+	/// have been unplugged as they never change.
+	const device_description* xinput_driver::find_device_desc(int device_id) const
+	{
+		int driver_id, slot;
+		split_device_id(device_id, &driver_id, &slot);
+		if(driver_id != m_driver_id || slot >= MaxDevices)
+			return 0;
+		const device_description& desc = m_devices[slot].m_desc;
+		if(!desc.name || desc.id != device_id)
+			return 0;
+		return &m_devices[slot].m_desc;
 	}
 	
 	void xinput_driver::enumerate_devices()
 	{
 		for(int i = 0; i < MaxDevices; ++i)
-		{
-			device &d = m_devices[i];
-			DWORD res = XInputGetCapabilities(i, XINPUT_FLAG_GAMEPAD, &d.m_device);
-			d.m_connected = res == ERROR_SUCCESS;
-			if(d.m_connected)
-			{
-				d.m_desc.id = make_device_id(m_driver_id, i);
-				d.m_desc.index = i;
-				d.m_desc.name  = "XBox 360 Controller";
-				d.m_desc.type  = device_xenoncontroller;
-				++m_num_devices;
-			}
-		}		
+			connect(i);
 	}
 
 } // end namespace
@@ -15,6 +15,7 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "input/input_abi.h"
 #include "input/driver_base.h"
+#include "input/gamepad_state.h"
 #include "core/pc/safe_windows.h"
 #include "d3d/include/XInput.h"
 
@@ -29,7 +30,9 @@ namespace input
 namespace pc
 {
  
-	/// Windows XInput driver, exposes 360 controllers.
+	/// Windows XInput driver, exposes 360 controllers. Pads are hot plugged, connected
+	/// pads are polled every update while only one empty slot is probed per update
+	/// as polling empty slots is expensive.
     class TYCHO_INPUT_ABI xinput_driver : public driver_base
     {
     public:
@@ -45,24 +48,44 @@ namespace pc
 		virtual void update(event_handler *);				    
 		virtual int get_num_devices() const;		
 		virtual const device_description* get_device_desc(int i) const;		    
+		virtual const device_description* find_device_desc(int device_id) const;
+		//@}
+		
+		/// \name gamepad configuration
+		//@{
+		void set_gamepad_config(const gamepad_config& config);
+		const gamepad_config& get_gamepad_config() const;
 		//@}
 		
 	private:
 		void enumerate_devices();
 		
+		/// start reporting the pad in a slot
+		/// \returns false if there is no pad in the slot
+		bool connect(int slot);
+		
+		/// stop reporting the pad in a slot, releasing anything it held
+		void disconnect(int slot, event_handler* handler);
+		
+		/// check a single empty slot for a new pad
+		void probe(event_handler* handler);
+		
 		static const int MaxDevices = 4;
 		
 		struct device
 		{
 			device_description  m_desc;
 			XINPUT_CAPABILITIES m_device;
-			bool				m_connected;
+			int					m_connected_index;	///< index in m_connected or -1
 			int					m_packet_num;
-			bool				m_gamepad_state_valid;
+			gamepad_state		m_state;		///< state as of the last packet
 		};
 		int		m_driver_id;
 		device	m_devices[MaxDevices];
+		int		m_connected[MaxDevices];	///< slots of the connected pads
 		int		m_num_devices;
+		int		m_next_probe;				///< next slot to probe for a new pad
+		gamepad_config m_config;
     };
 
 } // end namespace
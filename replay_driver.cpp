@@ -0,0 +1,140 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Saturday, 17 October 2026 04:52:47 PM
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "replay_driver.h"
+#include "input/timestamp.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+namespace tycho
+{
+namespace input
+{
+
+	/// constructor
+	replay_driver::replay_driver(const char* path, replay_mode mode) :
+		m_path(path),
+		m_mode(mode),
+		m_num_initial_devices(0),
+		m_events(0),
+		m_num_events(0),
+		m_cur_event(0),
+		m_started(false),
+		m_start_time(0),
+		m_start_timestamp(0)
+	{
+	}
+	
+	bool replay_driver::initialise(int)
+	{
+		if(!m_file.open_read(m_path))
+			return false;
+		
+		// validate the header and make sure the tables fit in the file
+		if(m_file.size() < sizeof(recording_header))
+			return false;
+		const recording_header* header = (const recording_header*)m_file.data();
+		if(header->magic != recording_header::Magic || header->version != recording_header::Version)
+			return false;
+		if(header->num_devices > header->device_capacity || header->num_initial_devices > header->num_devices)
+			return false;
+		size_t events_offset = sizeof(recording_header) + sizeof(recorded_device) * (size_t)header->device_capacity;
+		if(events_offset > m_file.size())
+			return false;
+		size_t max_events = (m_file.size() - events_offset) / sizeof(recorded_event);
+		
+		const recorded_device* rd = (const recorded_device*)(header + 1);
+		for(core::uint32 i = 0; i < header->num_devices; ++i, ++rd)
+		{
+			device_description desc;
+			desc.id = rd->id;
+			desc.type = (device_type)rd->type;
+			desc.name = rd->name;
+			desc.index = rd->index;
+			m_devices.push_back(desc);
+		}
+		m_num_initial_devices = (int)header->num_initial_devices;
+		m_events = (const recorded_event*)(m_file.data() + events_offset);
+		m_num_events = (int)(header->num_events < max_events ? header->num_events : max_events);
+		return true;
+	}
+	
+	void replay_driver::update(event_handler* handler)
+	{
+		if(is_finished())
+			return;
+		
+		if(m_mode == replay_fast)
+		{
+			int frame = m_events[m_cur_event].frame;
+			while(m_cur_event < m_num_events && m_events[m_cur_event].frame == frame)
+				issue(handler, m_events[m_cur_event++].packet);
+			return;
+		}
+		
+		core::int64 now = get_timestamp();
+		if(!m_started)
+		{
+			m_started = true;
+			m_start_time = now;
+			m_start_timestamp = m_events[0].packet.timestamp;
+		}
+		core::int64 elapsed = now - m_start_time;
+		while(m_cur_event < m_num_events && 
+			  m_events[m_cur_event].packet.timestamp - m_start_timestamp <= elapsed)
+		{
+			issue(handler, m_events[m_cur_event++].packet);
+		}
+	}
+	
+	int replay_driver::get_num_devices() const
+	{
+		return m_num_initial_devices;
+	}
+	
+	const device_description* replay_driver::get_device_desc(int i) const
+	{
+		return &m_devices[i];
+	}
+	
+	/// \returns the description of any device in the recording, including those that
+	///			 arrive during it, so the interface can look up replayed arrivals.
+	const device_description* replay_driver::find_device_desc(int device_id) const
+	{
+		for(size_t i = m_devices.size(); i-- > 0;)
+		{
+			if(m_devices[i].id == device_id)
+				return &m_devices[i];
+		}
+		return 0;
+	}
+	
+	/// issue a single recorded event
+	void replay_driver::issue(event_handler* handler, const event_packet& pkt) const
+	{
+		switch(pkt.ptype)
+		{
+			case packet_type_keyboard: handler->handle_keyboard_event(pkt.index, pkt.keyboard); break;
+			case packet_type_mouse: handler->handle_mouse_event(pkt.index, pkt.mouse); break;
+			case packet_type_axis: handler->handle_axis_event(pkt.index, pkt.axis); break;
+			case packet_type_device_added:
+			{
+				const device_description* desc = find_device_desc(pkt.index);
+				if(desc)
+					handler->handle_device_added(*desc);
+				break;
+			}
+			case packet_type_device_removed: handler->handle_device_removed(pkt.index); break;
+			default: break;
+		}
+	}
+
+} // end namespace
+} // end namespace
@@ -0,0 +1,87 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Saturday, 17 October 2026 04:52:47 PM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __REPLAY_DRIVER_H_B2E47C19_8D35_4A06_9F1B_5C7E0A3D6B82_
+#define __REPLAY_DRIVER_H_B2E47C19_8D35_4A06_9F1B_5C7E0A3D6B82_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+#include "input/driver_base.h"
+#include "input/input_recorder.h"
+#include "input/mapped_file.h"
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+
+	/// plays back a recording made by input_recorder. Events are read directly from 
+	/// the mapped recording. The devices in the recording are exposed with their 
+	/// original ids and descriptions so existing group bindings work unchanged, 
+	/// this means the replay driver should not be used alongside the live drivers
+	/// that made the recording. Devices that arrived or were removed while recording
+	/// do so again at the same point in the replay.
+	class TYCHO_INPUT_ABI replay_driver : public driver_base
+	{
+	public:
+		enum replay_mode
+		{
+			/// events are issued at the same rate they were recorded
+			replay_real_time,
+
+			/// one recorded frame is issued per update, as fast as the caller updates.
+			replay_fast
+		};
+
+		/// constructor
+		replay_driver(const char* path, replay_mode mode);
+
+		/// \name driver_base interface
+		//@{
+		virtual bool initialise(int driver_id);
+		virtual void update(event_handler *);
+		virtual int get_num_devices() const;
+		virtual const device_description* get_device_desc(int i) const;
+		virtual const device_description* find_device_desc(int device_id) const;
+		//@}
+
+		/// \returns true once every recorded event has been issued
+		bool is_finished() const { return m_cur_event >= m_num_events; }
+
+		/// \returns number of events in the recording
+		int get_num_events() const { return m_num_events; }
+
+	private:
+		/// issue a single recorded event
+		void issue(event_handler* handler, const event_packet& pkt) const;
+
+		const char*						m_path;
+		replay_mode						m_mode;
+		mapped_file						m_file;
+		std::vector<device_description> m_devices;			///< every device in the recording
+		int								m_num_initial_devices;	///< devices available from the start, the first entries
+		const recorded_event*			m_events;
+		int								m_num_events;
+		int								m_cur_event;
+		bool							m_started;
+		core::int64						m_start_time;		///< wall clock time of the first update
+		core::int64						m_start_timestamp;	///< timestamp of the first recorded event
+	};
+
+} // end namespace
+} // end namespace
+
+#endif // __REPLAY_DRIVER_H_B2E47C19_8D35_4A06_9F1B_5C7E0A3D6B82_
@@ -0,0 +1,894 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Saturday, 17 October 2026 01:40:12 PM
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/types.h"
+#include "input/binding_index.h"
+#include "input/interface.h"
+#include "input/combo_matcher.h"
+#include "input/name_table.h"
+#include "input/axis_normaliser.h"
+#include "input/job_system.h"
+#include "input/event_ring.h"
+#include "input/input_stream.h"
+#include "input/input_history.h"
+#include "input/input_recorder.h"
+#include "core/containers/scoped_hash_table.h"
+#if defined(__linux__)
+#include "input/linux/shm_driver.h"
+#include <unistd.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+
+using namespace tycho::input;
+
+//////////////////////////////////////////////////////////////////////////////
+// Input dispatch benchmarks. Results are written as CSV (default) or JSON
+// with one record per measurement so runs can be tracked over time.
+//
+// usage : input_bench [--csv | --json] [--quick]
+//////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+	typedef std::chrono::steady_clock bench_clock;
+	
+	/// \returns nanoseconds elapsed since start
+	double elapsed_ns(bench_clock::time_point start)
+	{
+		return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(bench_clock::now() - start).count();
+	}
+	
+	/// results of timed loops go here so the compiler can't throw the loops away
+	volatile size_t g_sink = 0;
+	
+	/// keep a result of a timed loop alive
+	void consume(size_t v)
+	{
+		g_sink = g_sink + v;
+	}
+	
+	/// simple deterministic random number generator so runs are comparable
+	struct bench_random
+	{
+		bench_random() : m_state(0x2545F491) {}
+		tycho::core::uint32 next() { m_state ^= m_state << 13; m_state ^= m_state >> 17; m_state ^= m_state << 5; return m_state; }
+		tycho::core::uint32 m_state;
+	};
+	
+	/// single measurement
+	struct bench_result
+	{
+		std::string suite;
+		std::string name;
+		double		value;
+		std::string unit;
+	};
+	
+	std::vector<bench_result> g_results;
+	
+	void report(const char* suite, const std::string& name, double value, const char* unit)
+	{
+		bench_result r;
+		r.suite = suite;
+		r.name = name;
+		r.value = value;
+		r.unit = unit;
+		g_results.push_back(r);
+	}
+	
+	void write_csv()
+	{
+		printf("suite,name,value,unit\n");
+		for(size_t i = 0; i < g_results.size(); ++i)
+		{
+			const bench_result& r = g_results[i];
+			printf("%s,%s,%.3f,%s\n", r.suite.c_str(), r.name.c_str(), r.value, r.unit.c_str());
+		}
+	}
+	
+	void write_json()
+	{
+		printf("{\n\t\"results\" : [\n");
+		for(size_t i = 0; i < g_results.size(); ++i)
+		{
+			const bench_result& r = g_results[i];
+			printf("\t\t{ \"suite\" : \"%s\", \"name\" : \"%s\", \"value\" : %.3f, \"unit\" : \"%s\" }%s\n", 
+				r.suite.c_str(), r.name.c_str(), r.value, r.unit.c_str(), i + 1 < g_results.size() ? "," : "");
+		}
+		printf("\t]\n}\n");
+	}
+	
+	/// make a random input, roughly the mix a game sees
+	input make_random_input(bench_random& rnd)
+	{
+		tycho::core::uint32 r = rnd.next();
+		switch(r % 4)
+		{
+			case 0: return make_mouse_input();
+			case 1: return make_axis_input((axis_type)(1 + (r >> 8) % (axis_count - 1)));
+			default: return make_keyboard_input((key_type)(1 + (r >> 8) % (key_count - 1)), (key_state)(1 + (r >> 16) % 2));
+		}
+	}
+	
+	typedef tycho::core::scoped_hash_table<input, const char*, 123> hashed_bindings;
+	
+	/// \returns number of inputs bound in the hashed table, looking each up passes times
+	size_t lookup_hashed(hashed_bindings& table, const std::vector<input>& lookups, int passes)
+	{
+		size_t hits = 0;
+		for(int p = 0; p < passes; ++p)
+		{
+			for(size_t i = 0; i < lookups.size(); ++i)
+				hits += table.find(lookups[i]) != 0;
+		}
+		return hits;
+	}
+	
+	/// \returns number of inputs bound in the dense index, looking each up passes times
+	size_t lookup_dense(const scoped_index<const char*>& index, const std::vector<input>& lookups, int passes)
+	{
+		size_t hits = 0;
+		for(int p = 0; p < passes; ++p)
+		{
+			for(size_t i = 0; i < lookups.size(); ++i)
+				hits += index.find(get_input_code(lookups[i])) != 0;
+		}
+		return hits;
+	}
+	
+	/// \returns the median of a set of timings
+	double median(std::vector<double>& times)
+	{
+		std::sort(times.begin(), times.end());
+		return times[times.size() / 2];
+	}
+	
+	/// compare resolving inputs through the hashed table against the dense index. A
+	/// single long run was at the mercy of frequency scaling and whatever else the
+	/// machine was doing, so the lookups are timed in rounds after a warm up round,
+	/// alternating which table goes first, and the median round is reported.
+	void bench_binding_lookup(int num_lookups)
+	{
+		const int NumBindings = 48;
+		const int NumInputs = 4096;		// cache resident so the lookups rather than the input stream are timed
+		const int Rounds = 15;
+		
+		static const char* names[NumBindings];
+		static char name_storage[NumBindings][16];
+		
+		bench_random rnd;
+		hashed_bindings hashed;
+		scoped_index<const char*> dense(input_code_count);
+		for(int i = 0; i < NumBindings; ++i)
+		{
+			snprintf(name_storage[i], sizeof(name_storage[i]), "action%d", i);
+			names[i] = name_storage[i];
+			input in = make_random_input(rnd);
+			hashed.push(in, names[i]);
+			dense.push(get_input_code(in), names[i]);
+		}
+		
+		std::vector<input> lookups(NumInputs);
+		for(int i = 0; i < NumInputs; ++i)
+			lookups[i] = make_random_input(rnd);
+		
+		int passes = num_lookups / (NumInputs * Rounds);
+		passes = passes < 1 ? 1 : passes;
+		double per_round = (double)passes * NumInputs;
+		std::vector<double> hashed_ns;
+		std::vector<double> dense_ns;
+		size_t hits_hashed = 0;
+		size_t hits_dense = 0;
+		for(int r = 0; r <= Rounds; ++r)
+		{
+			for(int t = 0; t < 2; ++t)
+			{
+				bool use_dense = ((r + t) & 1) != 0;
+				bench_clock::time_point start = bench_clock::now();
+				if(use_dense)
+					hits_dense += lookup_dense(dense, lookups, passes);
+				else
+					hits_hashed += lookup_hashed(hashed, lookups, passes);
+				double ns = elapsed_ns(start) / per_round;
+				if(r > 0)
+					(use_dense ? dense_ns : hashed_ns).push_back(ns);
+			}
+		}
+		
+		TYCHO_ASSERT(hits_hashed == hits_dense);
+		consume(hits_hashed + hits_dense);
+		report("binding_lookup", "scoped_hash_table", median(hashed_ns), "ns/lookup");
+		report("binding_lookup", "scoped_index", median(dense_ns), "ns/lookup");
+	}
+	
+	/// relative frequency of each event kind generated by the synthetic driver
+	struct event_mix
+	{
+		const char* name;
+		int keyboard;
+		int mouse;
+		int axis;
+	};
+	
+	/// driver generating a repeating pseudo random stream of events across many devices
+	class synthetic_driver : public driver_base
+	{
+	public:
+		synthetic_driver(int num_devices, int events_per_update, const event_mix& mix) :
+			m_num_devices(num_devices),
+			m_events_per_update(events_per_update),
+			m_mix(mix),
+			m_cur(0)
+		{}
+		
+		virtual bool initialise(int driver_id)
+		{
+			for(int i = 0; i < m_num_devices; ++i)
+			{
+				device_description desc = { make_device_id(driver_id, i), device_xenoncontroller, "Synthetic", i };
+				m_devices.push_back(desc);
+			}
+			
+			// pregenerate the stream so the benchmark doesn't measure the generator
+			bench_random rnd;
+			int total = m_mix.keyboard + m_mix.mouse + m_mix.axis;
+			m_events.resize(PoolSize);
+			for(int i = 0; i < PoolSize; ++i)
+			{
+				event_packet& p = m_events[i];
+				tycho::core::uint32 r = rnd.next();
+				int kind = (int)(r % total);
+				p.timestamp = 0;
+				p.index = m_devices[(r >> 8) % m_num_devices].id;
+				if(kind < m_mix.keyboard)
+				{
+					p.ptype = packet_type_keyboard;
+					p.keyboard = make_keyboard_packet((key_type)(1 + (r >> 12) % (key_count - 1)), (key_state)(1 + (r >> 20) % 2));
+				}
+				else if(kind < m_mix.keyboard + m_mix.mouse)
+				{
+					p.ptype = packet_type_mouse;
+					p.mouse = make_mouse_packet((int)(r >> 12) % 7 - 3, (int)(r >> 16) % 7 - 3);
+				}
+				else
+				{
+					p.ptype = packet_type_axis;
+					p.axis = make_axis_packet((axis_type)(1 + (r >> 12) % (axis_count - 1)), (float)(r >> 16) / 65535.0f);
+				}
+			}
+			return true;
+		}
+		
+		virtual void update(event_handler* handler)
+		{
+			for(int i = 0; i < m_events_per_update; ++i)
+			{
+				const event_packet& p = m_events[m_cur];
+				m_cur = (m_cur + 1) & (PoolSize - 1);
+				switch(p.ptype)
+				{
+					case packet_type_keyboard: handler->handle_keyboard_event(p.index, p.keyboard); break;
+					case packet_type_mouse: handler->handle_mouse_event(p.index, p.mouse); break;
+					case packet_type_axis: handler->handle_axis_event(p.index, p.axis); break;
+					default: break;
+				}
+			}
+		}
+		
+		virtual int get_num_devices() const { return m_num_devices; }
+		virtual const device_description* get_device_desc(int i) const { return &m_devices[i]; }
+		
+	private:
+		static const int PoolSize = 1 << 16;
+		
+		int m_num_devices;
+		int m_events_per_update;
+		event_mix m_mix;
+		int m_cur;
+		std::vector<device_description> m_devices;
+		std::vector<event_packet> m_events;
+	};
+	
+	/// driver pushing key packets with timestamps chosen so that drivers either
+	/// interleave event by event or follow each other in whole runs.
+	class merge_driver : public driver_base
+	{
+	public:
+		merge_driver(int slot, int num_drivers, int events_per_update, bool interleaved) :
+			m_slot(slot),
+			m_num_drivers(num_drivers),
+			m_events_per_update(events_per_update),
+			m_interleaved(interleaved),
+			m_update(0)
+		{}
+		
+		virtual bool initialise(int driver_id)
+		{
+			device_description desc = { make_device_id(driver_id, 0), device_xenoncontroller, "Merge", 0 };
+			m_device = desc;
+			return true;
+		}
+		
+		virtual void update(event_handler* handler)
+		{
+			// the interface hands each driver its ring, push directly to control the timestamps
+			event_ring* ring = static_cast<event_ring*>(handler);
+			tycho::core::int64 base = (tycho::core::int64)m_update++ * m_num_drivers * m_events_per_update;
+			for(int i = 0; i < m_events_per_update; ++i)
+			{
+				event_packet p;
+				p.timestamp = base + (m_interleaved ? (tycho::core::int64)i * m_num_drivers + m_slot : (tycho::core::int64)m_slot * m_events_per_update + i);
+				p.index = m_device.id;
+				p.ptype = packet_type_keyboard;
+				p.keyboard = make_keyboard_packet(key_button_a, (i & 1) ? key_state_up : key_state_down);
+				ring->push(p);
+			}
+		}
+		
+		virtual int get_num_devices() const { return 1; }
+		virtual const device_description* get_device_desc(int) const { return &m_device; }
+		
+	private:
+		int m_slot;
+		int m_num_drivers;
+		int m_events_per_update;
+		bool m_interleaved;
+		int m_update;
+		device_description m_device;
+	};
+	
+	/// handler that does the minimum amount of work
+	class counting_handler : public input_handler
+	{
+	public:
+		counting_handler() : m_count(0) {}
+		virtual bool handle_mouse(int, int, int) { ++m_count; return true; }
+		virtual bool handle_axis(int, const float) { ++m_count; return true; }
+		virtual bool handle_key(int, key_type, key_state) { ++m_count; return true; }
+		size_t m_count;
+	};
+	
+	/// counting handler that takes its actions in batches
+	class counting_batch_handler : public counting_handler
+	{
+	public:
+		virtual bool wants_batches() const { return true; }
+		virtual void handle_batch(const action_record*, int count) { m_count += count; }
+	};
+	
+	/// an action for every bindable input and a binding to each one
+	struct action_set
+	{
+		action_set()
+		{
+			add(make_mouse_input(), event_type_mouse);
+			for(int a = 1; a < axis_count; ++a)
+				add(make_axis_input((axis_type)a), event_type_axis);
+			for(int k = 1; k < key_count; ++k)
+			{
+				add(make_keyboard_input((key_type)k, key_state_down), event_type_key);
+				add(make_keyboard_input((key_type)k, key_state_up), event_type_key);
+			}
+			
+			action a_end = { 0, 0, event_type_invalid };
+			binding b_end = { 0, make_empty_input() };
+			actions.push_back(a_end);
+			bindings.push_back(b_end);
+			
+			// names are only stored once all have been generated as the vector may move them
+			for(size_t i = 0; i < names.size(); ++i)
+			{
+				actions[i].name = names[i].c_str();
+				bindings[i].action = names[i].c_str();
+			}
+		}
+		
+		void add(input trigger, event_type requirements)
+		{
+			char name[32];
+			snprintf(name, sizeof(name), "action%d", (int)names.size());
+			names.push_back(name);
+			action a = { 0, (int)actions.size(), requirements };
+			binding b = { 0, trigger };
+			actions.push_back(a);
+			bindings.push_back(b);
+		}
+		
+		std::vector<std::string> names;
+		std::vector<action> actions;
+		std::vector<binding> bindings;
+	};
+	
+	/// cost per event of interface::update for a mix of events spread across devices and groups
+	void bench_dispatch(const event_mix& mix, int num_devices, int num_groups, int events_per_update, int num_updates, bool batched = false)
+	{
+		action_set set;
+		interface ifc(0, num_groups > interface::DefaultGroups ? num_groups : interface::DefaultGroups);
+		synthetic_driver* driver = new synthetic_driver(num_devices, events_per_update, mix);
+		ifc.add_driver(driver);
+		ifc.register_bindings("Player", &set.bindings[0]);
+		
+		counting_handler per_event;
+		counting_batch_handler batch;
+		input_handler* handler = batched ? (input_handler*)&batch : (input_handler*)&per_event;
+		for(int g = 0; g < num_groups; ++g)
+			ifc.push_action_group(g, "Player", &set.actions[0], handler);
+		for(int d = 0; d < num_devices; ++d)
+			ifc.bind_device(d % num_groups, ifc.get_devices()[d].id);
+		
+		// warm up then time
+		for(int i = 0; i < 16; ++i)
+			ifc.update();
+		bench_clock::time_point start = bench_clock::now();
+		for(int i = 0; i < num_updates; ++i)
+			ifc.update();
+		double ns = elapsed_ns(start);
+		
+		char name[128];
+		snprintf(name, sizeof(name), "%s%s/devices=%d/groups=%d/events=%d", batched ? "batched/" : "", mix.name, num_devices, num_groups, events_per_update);
+		report("dispatch", name, ns / ((double)num_updates * events_per_update), "ns/event");
+		TYCHO_ASSERT(ifc.get_num_dropped_events() == 0);
+	}
+	
+	/// handler doing a fixed amount of gameplay work per action
+	class working_handler : public input_handler
+	{
+	public:
+		explicit working_handler(int work = 0) : m_work(work), m_sum(0) {}
+		virtual bool handle_mouse(int id, int, int) { return work(id); }
+		virtual bool handle_axis(int id, const float) { return work(id); }
+		virtual bool handle_key(int id, key_type, key_state) { return work(id); }
+		bool work(int id)
+		{
+			tycho::core::uint32 h = m_sum + id;
+			for(int i = 0; i < m_work; ++i)
+				h = h * 2654435761u + i;
+			m_sum = h;
+			return true;
+		}
+		int m_work;
+		tycho::core::uint32 m_sum;
+	};
+	
+	/// serial against parallel group dispatch with a handler per group doing real work
+	void bench_parallel_dispatch(int num_groups, int work, int events_per_update, int num_updates, int num_workers)
+	{
+		static const event_mix mix = { "keyboard", 1, 0, 0 };
+		action_set set;
+		interface ifc;
+		thread_pool pool(num_workers);
+		if(num_workers > 0)
+			ifc.set_job_system(&pool);
+		synthetic_driver* driver = new synthetic_driver(num_groups, events_per_update, mix);
+		ifc.add_driver(driver);
+		ifc.register_bindings("Player", &set.bindings[0]);
+		
+		std::vector<working_handler> handlers(num_groups, working_handler(work));
+		for(int g = 0; g < num_groups; ++g)
+		{
+			ifc.push_action_group(g, "Player", &set.actions[0], &handlers[g]);
+			ifc.bind_device(g, ifc.get_devices()[g].id);
+		}
+		
+		for(int i = 0; i < 16; ++i)
+			ifc.update();
+		bench_clock::time_point start = bench_clock::now();
+		for(int i = 0; i < num_updates; ++i)
+			ifc.update();
+		double ns = elapsed_ns(start);
+		
+		char name[128];
+		snprintf(name, sizeof(name), "workers=%d/groups=%d/work=%d/events=%d", num_workers, num_groups, work, events_per_update);
+		report("parallel_dispatch", name, ns / num_updates, "ns/update");
+		ifc.set_job_system(0);
+	}
+	
+	/// cost per event of merging several drivers' rings into timestamp order
+	void bench_merge(int num_drivers, int events_per_driver, bool interleaved, int num_updates)
+	{
+		action_set set;
+		interface ifc;
+		for(int d = 0; d < num_drivers; ++d)
+			ifc.add_driver(new merge_driver(d, num_drivers, events_per_driver, interleaved));
+		ifc.register_bindings("Player", &set.bindings[0]);
+		counting_handler handler;
+		ifc.push_action_group(0, "Player", &set.actions[0], &handler);
+		for(size_t i = 0; i < ifc.get_devices().size(); ++i)
+			ifc.bind_device(0, ifc.get_devices()[i].id);
+		
+		for(int i = 0; i < 16; ++i)
+			ifc.update();
+		bench_clock::time_point start = bench_clock::now();
+		for(int i = 0; i < num_updates; ++i)
+			ifc.update();
+		double ns = elapsed_ns(start);
+		
+		char name[96];
+		snprintf(name, sizeof(name), "%s/drivers=%d/events=%d", interleaved ? "interleaved" : "runs", num_drivers, events_per_driver);
+		report("merge", name, ns / ((double)num_updates * num_drivers * events_per_driver), "ns/event");
+	}
+	
+	/// size and speed of the input stream format against recording raw packets
+	void bench_stream(const event_mix& mix, int num_devices, int num_events, int iterations)
+	{
+		bench_random rnd;
+		int total = mix.keyboard + mix.mouse + mix.axis;
+		std::vector<event_packet> packets(num_events);
+		tycho::core::int64 now = 1000000000;
+		for(int i = 0; i < num_events; ++i)
+		{
+			event_packet& p = packets[i];
+			tycho::core::uint32 r = rnd.next();
+			int kind = (int)(r % total);
+			
+			// devices report in short bursts a few hundred microseconds apart
+			if((r >> 24) < 64)
+				now += 100000 + (r >> 4) % 400000;
+			p.timestamp = now;
+			p.index = make_device_id(0, (r >> 8) % num_devices);
+			if(kind < mix.keyboard)
+			{
+				p.ptype = packet_type_keyboard;
+				p.keyboard = make_keyboard_packet((key_type)(1 + (r >> 12) % (key_count - 1)), (key_state)(1 + (r >> 20) % 2));
+			}
+			else if(kind < mix.keyboard + mix.mouse)
+			{
+				p.ptype = packet_type_mouse;
+				p.mouse = make_mouse_packet((int)(r >> 12) % 7 - 3, (int)(r >> 16) % 7 - 3);
+			}
+			else
+			{
+				p.ptype = packet_type_axis;
+				p.axis = make_axis_packet((axis_type)(1 + (r >> 12) % (axis_count - 1)), (float)(r >> 16) / 65535.0f);
+			}
+		}
+		
+		stream_encoder enc;
+		bench_clock::time_point start = bench_clock::now();
+		for(int it = 0; it < iterations; ++it)
+		{
+			enc.reset();
+			for(int i = 0; i < num_events; ++i)
+				enc.encode(packets[i]);
+		}
+		double encode_ns = elapsed_ns(start);
+		
+		stream_decoder dec;
+		std::vector<event_packet> out(256);
+		size_t decoded = 0;
+		start = bench_clock::now();
+		for(int it = 0; it < iterations; ++it)
+		{
+			dec.reset();
+			dec.feed(enc.get_data(), enc.get_size());
+			while(int n = dec.decode(&out[0], (int)out.size()))
+				decoded += n;
+		}
+		double decode_ns = elapsed_ns(start);
+		TYCHO_ASSERT(decoded == (size_t)iterations * num_events);
+		
+		double events = (double)iterations * num_events;
+		double bytes_per_event = (double)enc.get_size() / num_events;
+		char name[96];
+		snprintf(name, sizeof(name), "%s/devices=%d", mix.name, num_devices);
+		report("stream_size", name, bytes_per_event, "bytes/event");
+		report("stream_size", std::string(name) + "/vs_recording", sizeof(recorded_event) / bytes_per_event, "x");
+		report("stream_encode", name, encode_ns / events, "ns/event");
+		report("stream_decode", name, decode_ns / events, "ns/event");
+		report("stream_decode", std::string(name) + "/throughput", enc.get_size() * (double)iterations / decode_ns, "GB/s");
+	}
+	
+#if defined(__linux__)
+	/// event handler that does nothing
+	struct null_event_handler : public driver_base::event_handler
+	{
+	};
+	
+	/// cost of writing events into the shared memory ring and of draining them
+	void bench_shm(int events_per_update, int num_updates)
+	{
+		char name[64];
+		snprintf(name, sizeof(name), "/tyinput_bench_%d", (int)getpid());
+		static const lnx::shm_driver::device_config devices[] = { { device_gamepad, "Bench Pad" } };
+		lnx::shm_driver driver(name, devices, 1, events_per_update);
+		if(!driver.initialise(0))
+			return;
+		tyi_shm_header* shm = tyi_shm_attach(name);
+		null_event_handler handler;
+		double write_ns = 0;
+		double read_ns = 0;
+		for(int u = 0; u < num_updates; ++u)
+		{
+			bench_clock::time_point start = bench_clock::now();
+			for(int i = 0; i < events_per_update; ++i)
+				tyi_shm_key(shm, 0, key_button_a, (i & 1) ? key_state_up : key_state_down);
+			write_ns += elapsed_ns(start);
+			start = bench_clock::now();
+			driver.update(&handler);
+			read_ns += elapsed_ns(start);
+		}
+		tyi_shm_detach(shm);
+		
+		char test[64];
+		snprintf(test, sizeof(test), "write/events=%d", events_per_update);
+		report("shm_driver", test, write_ns / ((double)num_updates * events_per_update), "ns/event");
+		snprintf(test, sizeof(test), "drain/events=%d", events_per_update);
+		report("shm_driver", test, read_ns / ((double)num_updates * events_per_update), "ns/event");
+	}
+#endif
+	
+	/// cost of pushing and popping an action group with its bindings
+	void bench_action_groups(int iterations)
+	{
+		action_set set;
+		interface ifc;
+		ifc.register_bindings("Player", &set.bindings[0]);
+		counting_handler handler;
+		
+		bench_clock::time_point start = bench_clock::now();
+		for(int i = 0; i < iterations; ++i)
+			ifc.push_action_group(0, "Player", &set.actions[0], &handler);
+		double push_ns = elapsed_ns(start);
+		
+		report("device_group_memory", "per_pushed_action_group", (double)(ifc.get_group_memory_usage(0) - ifc.get_group_memory_usage(1)) / iterations, "bytes");
+		
+		start = bench_clock::now();
+		for(int i = 0; i < iterations; ++i)
+			ifc.pop_action_group(0, "Player", &set.actions[0]);
+		double pop_ns = elapsed_ns(start);
+		
+		char name[64];
+		snprintf(name, sizeof(name), "push_action_group/bindings=%d", (int)set.names.size());
+		report("action_groups", name, push_ns / iterations, "ns/call");
+		snprintf(name, sizeof(name), "pop_action_group/bindings=%d", (int)set.names.size());
+		report("action_groups", name, pop_ns / iterations, "ns/call");
+		report("device_group_memory", "empty", (double)ifc.get_group_memory_usage(1), "bytes");
+	}
+	
+	/// cost of registering a binding set
+	void bench_register_bindings(int iterations)
+	{
+		action_set set;
+		std::vector<std::string> set_names(iterations);
+		for(int i = 0; i < iterations; ++i)
+		{
+			char name[32];
+			snprintf(name, sizeof(name), "Set%d", i);
+			set_names[i] = name;
+		}
+		
+		interface ifc;
+		bench_clock::time_point start = bench_clock::now();
+		for(int i = 0; i < iterations; ++i)
+			ifc.register_bindings(set_names[i].c_str(), &set.bindings[0]);
+		double ns = elapsed_ns(start);
+		
+		char name[64];
+		snprintf(name, sizeof(name), "register_bindings/bindings=%d", (int)set.names.size());
+		report("register_bindings", name, ns / iterations, "ns/call");
+	}
+
+	/// cost of matching key edges against a combo set with a modifier held. Scales with
+	/// the number of combos on the pressed key, not the number in the set.
+	void bench_combos(int num_combos, int num_events)
+	{
+		static const combo_type types[] = { combo_chord, combo_double_tap, combo_hold };
+		static const key_type modifiers[] = { key_shift, key_control, key_button_left_shoulder, key_button_right_shoulder };
+		std::vector<combo> combos(num_combos + 1);
+		std::vector<std::string> names(num_combos);
+		bench_random rnd;
+		for(int i = 0; i < num_combos; ++i)
+		{
+			char name[32];
+			snprintf(name, sizeof(name), "Combo%d", i);
+			names[i] = name;
+			combo c = { names[i].c_str(), types[i % 3], (key_type)(key_0 + i % (key_z - key_0 + 1)), 
+						{ modifiers[rnd.next() & 3], key_invalid, key_invalid }, 200 };
+			combos[i] = c;
+		}
+		combo end = { 0, combo_chord, key_invalid, { key_invalid, key_invalid, key_invalid }, 0 };
+		combos[num_combos] = end;
+		
+		name_table table;
+		combo_set set;
+		set.compile(&combos[0], table);
+		combo_matcher matcher;
+		matcher.push(&set);
+		
+		std::vector<key_type> keys(1024);
+		for(size_t i = 0; i < keys.size(); ++i)
+			keys[i] = (key_type)(key_0 + rnd.next() % (key_z - key_0 + 1));
+		
+		combo_matcher::match matches[combo_matcher::MaxMatches];
+		int num_matches = 0;
+		tycho::core::int64 now = 0;
+		bool consumed;
+		matcher.key_down(key_shift, now, matches, consumed);
+		bench_clock::time_point start = bench_clock::now();
+		for(int i = 0; i < num_events; ++i)
+		{
+			key_type k = keys[i & 1023];
+			now += 1000000;
+			num_matches += matcher.key_down(k, now, matches, consumed);
+			matcher.key_up(k);
+		}
+		double ns = elapsed_ns(start);
+		
+		char name[64];
+		snprintf(name, sizeof(name), "key_down_up/combos=%d/matched=%.2f", num_combos, (double)num_matches / num_events);
+		report("combos", name, ns / num_events, "ns/event");
+	}
+	
+	/// batch axis normalisation, vector path against the scalar fallback
+	void bench_normalise_axes(int num_devices, int iterations)
+	{
+		bench_random rnd;
+		std::vector<gamepad_state> states(num_devices);
+		for(int i = 0; i < num_devices; ++i)
+		{
+			states[i] = make_gamepad_state();
+			for(int a = 0; a < gamepad_axis_count; ++a)
+				states[i].axes[a] = (tycho::core::int16)(a >= gamepad_axis_ltrigger ? rnd.next() & 255 : rnd.next());
+		}
+		std::vector<float> out(num_devices * gamepad_axis_count);
+		
+		static const char* mode_names[] = { "axial", "radial", "scaled_radial" };
+		gamepad_config config = gamepad_config::make_default();
+		for(int m = 0; m < 3; ++m)
+		{
+			config.mode = (deadzone_mode)m;
+			for(int scalar = 0; scalar < 2; ++scalar)
+			{
+				bench_clock::time_point start = bench_clock::now();
+				for(int i = 0; i < iterations; ++i)
+				{
+					if(scalar)
+						normalise_gamepad_axes_scalar(&states[0], num_devices, config, &out[0]);
+					else
+						normalise_gamepad_axes(&states[0], num_devices, config, &out[0]);
+				}
+				double ns = elapsed_ns(start);
+				
+				char name[96];
+				snprintf(name, sizeof(name), "%s/%s/devices=%d", scalar ? "scalar" : "vector", mode_names[m], num_devices);
+				report("normalise_axes", name, ns / ((double)iterations * num_devices), "ns/device");
+			}
+		}
+	}
+
+	/// cost of snapshotting every group into a rollback history, and of a rollback that
+	/// corrects a remote player's input 8 ticks back and re-reads the window for every player
+	void bench_history(int num_groups, int iterations)
+	{
+		static const int RollbackTicks = 8;
+		interface ifc(0, num_groups);
+		input_history history(num_groups, RollbackTicks * 4);
+		
+		bench_clock::time_point start = bench_clock::now();
+		for(int i = 0; i < iterations; ++i)
+			history.snapshot(ifc);
+		double ns = elapsed_ns(start);
+		char name[64];
+		snprintf(name, sizeof(name), "snapshot/groups=%d", num_groups);
+		report("history", name, ns / ((double)iterations * num_groups), "ns/group");
+		
+		tick_input remote = *history.find(history.get_newest_tick(), 0);
+		int held = 0;
+		start = bench_clock::now();
+		for(int i = 0; i < iterations; ++i)
+		{
+			int first = history.get_newest_tick() - RollbackTicks + 1;
+			frame_state::set(remote.down, (key_type)(1 + i % (key_count - 1)));
+			history.overwrite(first, i % num_groups, remote);
+			history.repredict(first, i % num_groups);
+			for(int g = 0; g < num_groups; ++g)
+			{
+				for(int t = first; t < first + RollbackTicks; ++t)
+					held += history.find(t, g)->is_down(key_button_a);
+			}
+			held += (int)(history.get_hash(first) & 1);
+		}
+		ns = elapsed_ns(start);
+		snprintf(name, sizeof(name), "rollback/groups=%d/ticks=%d", num_groups, RollbackTicks);
+		report("history", name, ns / ((double)iterations * num_groups * RollbackTicks), "ns/group/tick");
+		TYCHO_ASSERT(held >= 0);
+		consume(held);
+	}
+
+} // end anonymous namespace
+
+int main(int argc, char* argv[])
+{
+	bool json = false;
+	int scale = 4;
+	for(int i = 1; i < argc; ++i)
+	{
+		if(strcmp(argv[i], "--json") == 0)
+			json = true;
+		else if(strcmp(argv[i], "--csv") == 0)
+			json = false;
+		else if(strcmp(argv[i], "--quick") == 0)
+			scale = 1;
+		else
+		{
+			fprintf(stderr, "usage : %s [--csv | --json] [--quick]\n", argv[0]);
+			return 1;
+		}
+	}
+	
+	static const event_mix mixes[] = {
+		{ "keyboard", 1, 0, 0 },
+		{ "mouse", 0, 1, 0 },
+		{ "gamepad", 1, 0, 3 },
+		{ "mixed", 2, 1, 1 }
+	};
+	
+	bench_binding_lookup(scale << 20);
+	for(size_t m = 0; m < sizeof(mixes) / sizeof(mixes[0]); ++m)
+	{
+		bench_dispatch(mixes[m], 1, 1, 64, scale * 2048);
+		bench_dispatch(mixes[m], 8, 8, 256, scale * 512);
+		bench_dispatch(mixes[m], 32, 8, 1000, scale * 128);
+		bench_dispatch(mixes[m], 32, 8, 1000, scale * 128, true);
+	}
+	
+	// a bot per group on a server, busy frames and nearly idle ones where any per group cost would show
+	for(int groups = 8; groups <= 512; groups *= 8)
+	{
+		bench_dispatch(mixes[2], groups, groups, 1024, scale * 128);
+		bench_dispatch(mixes[2], groups, groups, 8, scale * 8192);
+	}
+	for(int interleaved = 0; interleaved < 2; ++interleaved)
+	{
+		bench_merge(1, 256, interleaved != 0, scale * 1024);
+		bench_merge(2, 256, interleaved != 0, scale * 512);
+		bench_merge(4, 256, interleaved != 0, scale * 256);
+		bench_merge(8, 128, interleaved != 0, scale * 256);
+	}
+	for(size_t m = 0; m < sizeof(mixes) / sizeof(mixes[0]); ++m)
+	{
+		bench_stream(mixes[m], 1, 1 << 16, scale * 8);
+		bench_stream(mixes[m], 8, 1 << 16, scale * 8);
+	}
+#if defined(__linux__)
+	bench_shm(64, scale * 1024);
+	bench_shm(1024, scale * 128);
+#endif
+	bench_action_groups(scale * 256);
+	bench_register_bindings(scale * 256);
+	{
+		int workers = (int)std::thread::hardware_concurrency() - 1;
+		workers = workers < 1 ? 1 : (workers > 7 ? 7 : workers);
+		bench_parallel_dispatch(8, 0, 1024, scale * 64, 0);
+		bench_parallel_dispatch(8, 0, 1024, scale * 64, workers);
+		bench_parallel_dispatch(8, 2000, 1024, scale * 16, 0);
+		bench_parallel_dispatch(8, 2000, 1024, scale * 16, workers);
+	}
+	bench_combos(0, scale << 20);
+	bench_combos(16, scale << 20);
+	bench_combos(1024, scale << 20);
+	bench_normalise_axes(4, scale * 16384);
+	bench_normalise_axes(64, scale * 1024);
+	for(int groups = 8; groups <= 512; groups *= 8)
+		bench_history(groups, scale * 32768 / groups * 8);
+	
+	if(json)
+		write_json();
+	else
+		write_csv();
+	return 0;
+}
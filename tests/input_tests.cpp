@@ -8,8 +8,1913 @@
 // INCLUDES
 //////////////////////////////////////////////////////////////////////////////
 #include "core/debug/assert.h"
+#include "input/device_router.h"
+#include "input/event_ring.h"
+#include "input/interface.h"
+#include "input/capture_thread.h"
+#include "input/binding_index.h"
+#include "input/binding_set.h"
+#include "input/combo_matcher.h"
+#include "input/allocator.h"
+#include "input/job_system.h"
+#include "input/latency_histogram.h"
+#include "input/name_table.h"
+#include "input/replay_driver.h"
+#include "input/mapped_file.h"
+#include "input/input_stream.h"
+#include "input/input_history.h"
+#include "input/timestamp.h"
+#include "input/gamepad_state.h"
+#include "input/axis_normaliser.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#if defined(__linux__)
+#include "input/linux/evdev_driver.h"
+#include "input/linux/shm_driver.h"
+#include <linux/input.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <new>
+#include <stdlib.h>
+
+using namespace tycho::input;
+
+// every heap allocation in the test goes through here so paths can be checked for allocations
+namespace
+{
+	bool g_count_allocations = false;
+	int g_num_allocations = 0;
+}
+
+// kept out of line so gcc doesn't see free() called on memory from new
+#if defined(__GNUC__)
+#define INPUT_TEST_NOINLINE __attribute__((noinline))
+#else
+#define INPUT_TEST_NOINLINE
+#endif
+
+INPUT_TEST_NOINLINE void* operator new(size_t size)
+{
+	if(g_count_allocations)
+		++g_num_allocations;
+	void* p = malloc(size ? size : 1);
+	if(!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+INPUT_TEST_NOINLINE void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+#define INPUT_TEST_CHECK(_expr) \
+	if(!(_expr)) { printf("%s(%d) : check failed : %s\n", __FILE__, __LINE__, #_expr); return false; }
+
+namespace
+{
+
+	bool test_device_router()
+	{
+		device_router router;
+		int kb = make_device_id(0, 0);
+		int pad = make_device_id(2, 3);
+		INPUT_TEST_CHECK(router.find_group(kb) == -1);
+		INPUT_TEST_CHECK(router.find_group(-1) == -1);
+		router.set_group(kb, 1);
+		router.set_group(pad, 5);
+		INPUT_TEST_CHECK(router.find_group(kb) == 1);
+		INPUT_TEST_CHECK(router.find_group(pad) == 5);
+		INPUT_TEST_CHECK(router.find_group(make_device_id(2, 2)) == -1);
+		router.set_group(pad, 0);
+		INPUT_TEST_CHECK(router.find_group(pad) == 0);
+		router.clear(pad);
+		INPUT_TEST_CHECK(router.find_group(pad) == -1);
+		return true;
+	}
+
+	bool test_event_ring()
+	{
+		event_ring ring(6);
+		INPUT_TEST_CHECK(ring.get_capacity() == 8);
+		
+		event_ring::span spans[2];
+		INPUT_TEST_CHECK(ring.acquire(spans) == 0);
+		
+		// fill past capacity, the overflow is dropped and counted
+		for(int i = 0; i < 10; ++i)
+			ring.handle_mouse_event(i, make_mouse_packet(i, -i));
+		INPUT_TEST_CHECK(ring.get_num_dropped() == 2);
+		INPUT_TEST_CHECK(ring.get_high_water() == 8);
+		INPUT_TEST_CHECK(ring.acquire(spans) == 1);
+		INPUT_TEST_CHECK(spans[0].count == 8);
+		INPUT_TEST_CHECK(spans[0].packets[3].index == 3);
+		INPUT_TEST_CHECK(spans[0].packets[3].ptype == packet_type_mouse);
+		ring.release(5);
+		
+		// wrap around the end of the storage
+		for(int i = 0; i < 4; ++i)
+			ring.handle_keyboard_event(100 + i, make_keyboard_packet(key_a, key_state_down));
+		INPUT_TEST_CHECK(ring.acquire(spans) == 2);
+		INPUT_TEST_CHECK(spans[0].count == 3 && spans[1].count == 4);
+		INPUT_TEST_CHECK(spans[0].packets[0].index == 5);
+		INPUT_TEST_CHECK(spans[1].packets[0].index == 100);
+		ring.release(spans[0].count + spans[1].count);
+		INPUT_TEST_CHECK(ring.acquire(spans) == 0);
+		return true;
+	}
+	
+	bool test_packed_input()
+	{
+		// inputs can be built and inspected at compile time
+		static_assert(sizeof(input) == 4, "input should pack into a word");
+		static_assert(make_keyboard_input(key_z, key_state_up).key() == key_z, "");
+		static_assert(make_keyboard_input(key_z, key_state_up).state() == key_state_up, "");
+		static_assert(make_axis_input(axis_ltrigger_x).axis() == axis_ltrigger_x, "");
+		static_assert(make_mouse_input().event() == event_type_mouse, "");
+		static_assert(!(make_mouse_input() == make_empty_input()), "");
+		
+		input in = make_keyboard_input(key_button_dpad_right, key_state_down);
+		input_fields f = in.fields();
+		INPUT_TEST_CHECK(f.event == event_type_key);
+		INPUT_TEST_CHECK(f.key == key_button_dpad_right);
+		INPUT_TEST_CHECK(f.state == key_state_down);
+		INPUT_TEST_CHECK(f.axis == axis_type_invalid);
+		INPUT_TEST_CHECK(make_input(f) == in);
+		INPUT_TEST_CHECK(hash(in) == hash(make_input(f)));
+		return true;
+	}
+	
+	bool test_scoped_index()
+	{
+		// every input gets a distinct code
+		std::vector<bool> used(input_code_count, false);
+		used[input_code_mouse] = true;
+		for(int a = 0; a < axis_count; ++a)
+		{
+			int code = get_input_code(make_axis_input((axis_type)a));
+			INPUT_TEST_CHECK(code > 0 && code < input_code_count && !used[code]);
+			used[code] = true;
+		}
+		for(int k = 0; k < key_count; ++k)
+		{
+			for(int st = 0; st < key_state_count; ++st)
+			{
+				int code = get_input_code(make_keyboard_input((key_type)k, (key_state)st));
+				INPUT_TEST_CHECK(code > 0 && code < input_code_count && !used[code]);
+				used[code] = true;
+			}
+		}
+		INPUT_TEST_CHECK(get_input_code(make_empty_input()) == input_code_none);
+		
+		// later pushes shadow earlier ones until popped
+		scoped_index<int> index(input_code_count);
+		int jump = get_input_code(make_keyboard_input(key_button_a, key_state_down));
+		INPUT_TEST_CHECK(index.find(jump) == 0);
+		index.push(jump, 1);
+		index.push(input_code_mouse, 2);
+		index.push(jump, 3);
+		INPUT_TEST_CHECK(*index.find(jump) == 3);
+		index.pop(jump);
+		INPUT_TEST_CHECK(*index.find(jump) == 1);
+		index.push(jump, 4);
+		INPUT_TEST_CHECK(*index.find(jump) == 4);
+		index.pop(jump);
+		index.pop(jump);
+		INPUT_TEST_CHECK(index.find(jump) == 0);
+		INPUT_TEST_CHECK(*index.find(input_code_mouse) == 2);
+		INPUT_TEST_CHECK(index.find(input_code_count + 100) == 0);
+		return true;
+	}
+	
+	bool test_name_table()
+	{
+		static char names[200][16];
+		name_table table;
+		INPUT_TEST_CHECK(table.find("Jump") == -1);
+		for(int i = 0; i < 200; ++i)
+		{
+			snprintf(names[i], sizeof(names[i]), "action%d", i);
+			INPUT_TEST_CHECK(table.intern(names[i]) == i);
+		}
+		INPUT_TEST_CHECK(table.size() == 200);
+		
+		// lookups compare contents not pointers
+		char copy[16];
+		for(int i = 0; i < 200; ++i)
+		{
+			snprintf(copy, sizeof(copy), "action%d", i);
+			INPUT_TEST_CHECK(table.find(copy) == i);
+			INPUT_TEST_CHECK(table.intern(copy) == i);
+			INPUT_TEST_CHECK(table.get_name(i) == names[i]);
+		}
+		INPUT_TEST_CHECK(table.find("action200") == -1);
+		return true;
+	}
+	
+	/// driver that replays a scripted list of packets on each update
+	class test_driver : public driver_base
+	{
+	public:
+		test_driver() : m_driver_id(0) {}
+		virtual bool initialise(int driver_id)
+		{
+			m_driver_id = driver_id;
+			device_description kb = { make_device_id(driver_id, 0), device_keyboard, "Test Keyboard", 0 };
+			device_description pad = { make_device_id(driver_id, 1), device_xenoncontroller, "Test Pad", 0 };
+			m_descs.push_back(kb);
+			m_descs.push_back(pad);
+			return true;
+		}
+		virtual void update(event_handler* handler)
+		{
+			for(size_t i = 0; i < m_pending.size(); ++i)
+			{
+				const event_packet& p = m_pending[i];
+				switch(p.ptype)
+				{
+					case packet_type_keyboard: handler->handle_keyboard_event(p.index, p.keyboard); break;
+					case packet_type_mouse: handler->handle_mouse_event(p.index, p.mouse); break;
+					case packet_type_axis: handler->handle_axis_event(p.index, p.axis); break;
+					default: break;
+				}
+			}
+			m_pending.clear();
+		}
+		virtual int get_num_devices() const { return (int)m_descs.size(); }
+		virtual const device_description* get_device_desc(int i) const { return &m_descs[i]; }
+		
+		void key(int device_num, key_type k, key_state s)
+		{
+			event_packet p;
+			p.timestamp = 0;
+			p.index = make_device_id(m_driver_id, device_num);
+			p.ptype = packet_type_keyboard;
+			p.keyboard = make_keyboard_packet(k, s);
+			m_pending.push_back(p);
+		}
+		void mouse(int device_num, int dx, int dy)
+		{
+			event_packet p;
+			p.timestamp = 0;
+			p.index = make_device_id(m_driver_id, device_num);
+			p.ptype = packet_type_mouse;
+			p.mouse = make_mouse_packet(dx, dy);
+			m_pending.push_back(p);
+		}
+		void axis(int device_num, axis_type a, float v)
+		{
+			event_packet p;
+			p.timestamp = 0;
+			p.index = make_device_id(m_driver_id, device_num);
+			p.ptype = packet_type_axis;
+			p.axis = make_axis_packet(a, v);
+			m_pending.push_back(p);
+		}
+		
+		int m_driver_id;
+		std::vector<device_description> m_descs;
+		std::vector<event_packet> m_pending;
+	};
+	
+	/// handler that records every action it sees
+	class test_handler : public input_handler
+	{
+	public:
+		test_handler() : m_num_keys(0), m_num_axes(0), m_num_mouse(0), m_last_action(-1), m_last_value(0), m_dx(0), m_dy(0) {}
+		virtual bool handle_mouse(int action_id, int dx, int dy)
+			{ ++m_num_mouse; m_last_action = action_id; m_dx = dx; m_dy = dy; return true; }
+		virtual bool handle_axis(int action_id, const float value)
+			{ ++m_num_axes; m_last_action = action_id; m_last_value = value; return true; }
+		virtual bool handle_key(int action_id, key_type, key_state)
+			{ ++m_num_keys; m_last_action = action_id; return true; }
+		int m_num_keys;
+		int m_num_axes;
+		int m_num_mouse;
+		int m_last_action;
+		float m_last_value;
+		int m_dx;
+		int m_dy;
+	};
+	
+	/// driver that taps a button on every update
+	class tapping_driver : public driver_base
+	{
+	public:
+		tapping_driver() : m_driver_id(0) {}
+		virtual bool initialise(int driver_id) { m_driver_id = driver_id; return true; }
+		virtual void update(event_handler* handler)
+		{
+			handler->handle_keyboard_event(make_device_id(m_driver_id, 0), make_keyboard_packet(key_button_a, key_state_down));
+			handler->handle_keyboard_event(make_device_id(m_driver_id, 0), make_keyboard_packet(key_button_a, key_state_up));
+		}
+		virtual int get_num_devices() const { return 0; }
+		virtual const device_description* get_device_desc(int) const { return 0; }
+		int m_driver_id;
+	};
+	
+	bool test_capture_thread()
+	{
+		tapping_driver driver;
+		event_ring ring(4096);
+		std::vector<driver_base*> drivers(1, &driver);
+		std::vector<event_ring*> rings(1, &ring);
+		
+		capture_thread capture;
+		capture.start(drivers, rings, 1000);
+		INPUT_TEST_CHECK(capture.is_running());
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		capture.stop();
+		INPUT_TEST_CHECK(!capture.is_running());
+		INPUT_TEST_CHECK(capture.get_num_updates() > 0);
+		
+		// every tap inside the window must be seen in order with non decreasing timestamps
+		event_ring::span spans[2];
+		int num_spans = ring.acquire(spans);
+		INPUT_TEST_CHECK(num_spans == 1);
+		INPUT_TEST_CHECK(spans[0].count == (int)capture.get_num_updates() * 2);
+		for(int i = 1; i < spans[0].count; ++i)
+		{
+			const event_packet& prev = spans[0].packets[i-1];
+			const event_packet& cur = spans[0].packets[i];
+			INPUT_TEST_CHECK(cur.timestamp - prev.timestamp >= 0);
+			INPUT_TEST_CHECK(cur.keyboard.state != prev.keyboard.state);
+		}
+		return true;
+	}
+	
+	bool test_interface_dispatch()
+	{
+		static const action actions[] = {
+			{ "Jump", 1, event_type_key },
+			{ "Turn", 2, event_type_axis },
+			{ 0, 0, event_type_invalid }
+		};
+		static const binding bindings[] = {
+			{ "Jump", make_keyboard_input(key_button_a, key_state_down) },
+			{ "Turn", make_axis_input(axis_lthumb_x) },
+			{ 0, make_empty_input() }
+		};
+		
+		interface ifc;
+		test_driver* driver = new test_driver();
+		ifc.add_driver(driver);
+		INPUT_TEST_CHECK(ifc.get_devices().size() == 2);
+		ifc.bind_device(1, driver->m_descs[1].id);
+		ifc.register_bindings("Player", bindings);
+		test_handler handler;
+		ifc.push_action_group(1, "Player", actions, &handler);
+		
+		driver->key(1, key_button_a, key_state_down);
+		driver->key(1, key_button_a, key_state_up);		// unbound
+		driver->key(0, key_button_a, key_state_down);	// device not in a group
+		driver->axis(1, axis_lthumb_x, 0.5f);
+		ifc.update();
+		INPUT_TEST_CHECK(handler.m_num_keys == 1);
+		INPUT_TEST_CHECK(handler.m_num_axes == 1);
+		INPUT_TEST_CHECK(handler.m_last_action == 2);
+		INPUT_TEST_CHECK(handler.m_last_value == 0.5f);
+		INPUT_TEST_CHECK(ifc.get_num_dropped_events() == 0);
+		
+		ifc.pop_action_group(1, "Player", actions);
+		driver->key(1, key_button_a, key_state_down);
+		ifc.update();
+		INPUT_TEST_CHECK(handler.m_num_keys == 1);
+		return true;
+	}
+
+	bool test_binding_layers()
+	{
+		static const action game_actions[] = {
+			{ "Jump", 1, event_type_key },
+			{ "Fire", 2, event_type_key },
+			{ 0, 0, event_type_invalid }
+		};
+		static const action menu_actions[] = {
+			{ "Select", 3, event_type_key },
+			{ 0, 0, event_type_invalid }
+		};
+		static const binding game_bindings[] = {
+			{ "Jump", make_keyboard_input(key_button_a, key_state_down) },
+			{ "Fire", make_keyboard_input(key_button_b, key_state_down) },
+			{ 0, make_empty_input() }
+		};
+		static const binding menu_bindings[] = {
+			{ "Select", make_keyboard_input(key_button_a, key_state_down) },
+			{ 0, make_empty_input() }
+		};
+		
+		name_table names;
+		binding_set game;
+		game.compile(game_bindings, names);
+		INPUT_TEST_CHECK(game.size() == 2);
+		INPUT_TEST_CHECK(game.find(get_input_code(make_keyboard_input(key_button_b, key_state_down))) == names.find("Fire"));
+		INPUT_TEST_CHECK(game.find(get_input_code(make_keyboard_input(key_button_b, key_state_up))) == -1);
+		
+		interface ifc;
+		test_driver* driver = new test_driver();
+		ifc.add_driver(driver);
+		ifc.bind_device(0, driver->m_descs[1].id);
+		ifc.register_bindings("Game", game_bindings);
+		ifc.register_bindings("Menu", menu_bindings);
+		test_handler handler;
+		ifc.push_action_group(0, "Game", game_actions, &handler);
+		ifc.push_action_group(0, "Menu", menu_actions, &handler);
+		
+		// the menu shadows A but B falls through to the game layer
+		driver->key(1, key_button_a, key_state_down);
+		ifc.update();
+		INPUT_TEST_CHECK(handler.m_last_action == 3);
+		driver->key(1, key_button_b, key_state_down);
+		ifc.update();
+		INPUT_TEST_CHECK(handler.m_last_action == 2);
+		
+		ifc.pop_action_group(0, "Menu", menu_actions);
+		driver->key(1, key_button_a, key_state_down);
+		ifc.update();
+		INPUT_TEST_CHECK(handler.m_last_action == 1);
+		INPUT_TEST_CHECK(handler.m_num_keys == 3);
+		return true;
+	}
+
+	bool test_latency_stats()
+	{
+		// buckets are exact below SubBuckets and within 1/SubBuckets above
+		latency_histogram h;
+		INPUT_TEST_CHECK(h.get_count() == 0 && h.get_percentile(50) == 0);
+		for(tycho::core::uint32 v = 1; v < 100000; v = v * 3 + 1)
+		{
+			int b = latency_histogram::get_bucket(v);
+			INPUT_TEST_CHECK(latency_histogram::get_bucket_min(b) <= v && v <= latency_histogram::get_bucket_max(b));
+			INPUT_TEST_CHECK(latency_histogram::get_bucket_max(b) - latency_histogram::get_bucket_min(b) <= v / latency_histogram::SubBuckets);
+		}
+		INPUT_TEST_CHECK(latency_histogram::get_bucket(0xffffffff) == latency_histogram::NumBuckets - 1);
+		for(tycho::core::uint32 v = 1; v <= 100; ++v)
+			h.record(v * 100);
+		INPUT_TEST_CHECK(h.get_count() == 100 && h.get_min() == 100 && h.get_max() == 10000);
+		INPUT_TEST_CHECK(h.get_mean() == 5050.0);
+		tycho::core::uint32 p50 = h.get_percentile(50);
+		INPUT_TEST_CHECK(p50 >= 5000 && p50 < 5000 + 5000 / latency_histogram::SubBuckets);
+		INPUT_TEST_CHECK(h.get_percentile(100) == 10000);
+		
+		latency_histogram other;
+		other.record(3);
+		h.merge(other);
+		INPUT_TEST_CHECK(h.get_count() == 101 && h.get_min() == 3);
+		INPUT_TEST_CHECK(h.get_percentile(0) == 3);
+
+#if TYCHO_INPUT_LATENCY_STATS
+		// only events that reach a handler are measured, per group and device type
+		static const action actions[] = {
+			{ "Jump", 1, event_type_key },
+			{ 0, 0, event_type_invalid }
+		};
+		static const binding bindings[] = {
+			{ "Jump", make_keyboard_input(key_button_a, key_state_down) },
+			{ 0, make_empty_input() }
+		};
+		interface ifc;
+		test_driver* driver = new test_driver();
+		ifc.add_driver(driver);
+		ifc.bind_device(1, driver->m_descs[0].id);
+		ifc.bind_device(1, driver->m_descs[1].id);
+		ifc.register_bindings("Player", bindings);
+		test_handler handler;
+		ifc.push_action_group(1, "Player", actions, &handler);
+		driver->key(0, key_button_a, key_state_down);
+		driver->key(0, key_button_a, key_state_up);
+		driver->key(1, key_button_a, key_state_down);
+		driver->key(1, key_button_a, key_state_down);
+		ifc.update();
+		INPUT_TEST_CHECK(handler.m_num_keys == 3);
+		INPUT_TEST_CHECK(ifc.get_group_latency(1).get_count() == 3);
+		INPUT_TEST_CHECK(ifc.get_group_latency(0).get_count() == 0);
+		INPUT_TEST_CHECK(ifc.get_device_latency(device_keyboard).get_count() == 1);
+		INPUT_TEST_CHECK(ifc.get_device_latency(device_xenoncontroller).get_count() == 2);
+		// captured during this update so nowhere near a second old
+		INPUT_TEST_CHECK(ifc.get_group_latency(1).get_max() < 1000000);
+		ifc.reset_latency_stats();
+		INPUT_TEST_CHECK(ifc.get_group_latency(1).get_count() == 0);
+		ifc.pop_action_group(1, "Player", actions);
+		
+		// a hold noticed by a later update counts from when its hold time ran out
+		static const combo holds[] = {
+			{ "Jump", combo_hold, key_button_b, { key_invalid }, 10 },
+			{ 0, combo_chord, key_invalid, { key_invalid }, 0 }
+		};
+		ifc.register_combos("Holds", holds);
+		ifc.push_action_group(1, "Holds", actions, &handler);
+		driver->key(1, key_button_b, key_state_down);
+		ifc.update();
+		ifc.reset_latency_stats();
+		std::this_thread::sleep_for(std::chrono::milliseconds(40));
+		ifc.update();
+		INPUT_TEST_CHECK(handler.m_num_keys == 4);
+		INPUT_TEST_CHECK(ifc.get_group_latency(1).get_count() == 1);
+		INPUT_TEST_CHECK(ifc.get_group_latency(1).get_min() >= 20000);
+		ifc.pop_action_group(1, "Holds", actions);
+#endif
+		return true;
+	}
+	
+	bool test_combos()
+	{
+		static const combo combos[] = {
+			{ "Sprint", combo_chord, key_e, { key_shift }, 0 },
+			{ "Dash", combo_chord, key_e, { key_shift, key_control }, 0 },
+			{ "Dodge", combo_double_tap, key_button_a, { key_invalid }, 250 },
+			{ "Charge", combo_hold, key_button_b, { key_button_left_shoulder }, 500 },
+			{ 0, combo_chord, key_invalid, { key_invalid }, 0 }
+		};
+		name_table names;
+		combo_set set;
+		set.compile(combos, names);
+		INPUT_TEST_CHECK(set.size() == 4);
+		int sprint = names.find("Sprint");
+		int dash = names.find("Dash");
+		
+		// the most specific chord wins and takes the press
+		combo_matcher matcher;
+		matcher.push(&set);
+		combo_matcher::match m[combo_matcher::MaxMatches];
+		bool consumed;
+		INPUT_TEST_CHECK(matcher.key_down(key_e, 0, m, consumed) == 0 && !consumed);
+		matcher.key_up(key_e);
+		matcher.key_down(key_shift, 0, m, consumed);
+		INPUT_TEST_CHECK(matcher.key_down(key_e, 10, m, consumed) == 1 && consumed);
+		INPUT_TEST_CHECK(m[0].action_id == sprint && m[0].key == key_e);
+		matcher.key_up(key_e);
+		matcher.key_down(key_control, 20, m, consumed);
+		INPUT_TEST_CHECK(matcher.key_down(key_e, 30, m, consumed) == 1 && m[0].action_id == dash);
+		matcher.key_up(key_e);
+		matcher.key_up(key_shift);
+		matcher.key_up(key_control);
+		
+		// timestamps are in nanoseconds, double taps must be inside the window and don't chain into a third tap
+		INPUT_TEST_CHECK(matcher.key_down(key_button_a, 0, m, consumed) == 0);
+		matcher.key_up(key_button_a);
+		INPUT_TEST_CHECK(matcher.key_down(key_button_a, 200000000, m, consumed) == 1 && !consumed);
+		matcher.key_up(key_button_a);
+		INPUT_TEST_CHECK(matcher.key_down(key_button_a, 300000000, m, consumed) == 0);
+		matcher.key_up(key_button_a);
+		INPUT_TEST_CHECK(matcher.key_down(key_button_a, 800000000, m, consumed) == 0);
+		
+		// holds complete on update once long enough, releasing early cancels them
+		matcher.key_down(key_button_b, 0, m, consumed);
+		INPUT_TEST_CHECK(!matcher.has_holds());
+		matcher.key_up(key_button_b);
+		matcher.key_down(key_button_left_shoulder, 0, m, consumed);
+		matcher.key_down(key_button_b, 1000000, m, consumed);
+		INPUT_TEST_CHECK(matcher.has_holds());
+		INPUT_TEST_CHECK(matcher.update(400000000, m) == 0);
+		INPUT_TEST_CHECK(matcher.update(520000000, m) == 1 && m[0].action_id == names.find("Charge"));
+		INPUT_TEST_CHECK(m[0].timestamp == 501000000);
+		INPUT_TEST_CHECK(!matcher.has_holds());
+		matcher.key_up(key_button_b);
+		matcher.key_down(key_button_b, 600000000, m, consumed);
+		matcher.key_up(key_button_b);
+		INPUT_TEST_CHECK(!matcher.has_holds());
+		matcher.key_down(key_button_b, 700000000, m, consumed);
+		matcher.pop(&set);
+		INPUT_TEST_CHECK(!matcher.has_holds());
+		
+		// through the interface, combos reach the same handlers as bindings
+		static const action actions[] = {
+			{ "Use", 1, event_type_key },
+			{ "Sprint", 2, event_type_key },
+			{ "Charge", 3, event_type_key },
+			{ 0, 0, event_type_invalid }
+		};
+		static const binding bindings[] = {
+			{ "Use", make_keyboard_input(key_e, key_state_down) },
+			{ 0, make_empty_input() }
+		};
+		static const combo player_combos[] = {
+			{ "Sprint", combo_chord, key_e, { key_shift }, 0 },
+			{ "Charge", combo_hold, key_button_b, { key_invalid }, 0 },
+			{ 0, combo_chord, key_invalid, { key_invalid }, 0 }
+		};
+		interface ifc;
+		test_driver* driver = new test_driver();
+		ifc.add_driver(driver);
+		ifc.bind_device(0, driver->m_descs[0].id);
+		ifc.bind_device(0, driver->m_descs[1].id);
+		ifc.register_bindings("Player", bindings);
+		ifc.register_combos("Player", player_combos);
+		test_handler handler;
+		ifc.push_action_group(0, "Player", actions, &handler);
+		driver->key(0, key_e, key_state_down);
+		ifc.update();
+		INPUT_TEST_CHECK(handler.m_num_keys == 1 && handler.m_last_action == 1);
+		driver->key(0, key_e, key_state_up);
+		driver->key(0, key_shift, key_state_down);
+		driver->key(0, key_e, key_state_down);
+		ifc.update();
+		INPUT_TEST_CHECK(handler.m_num_keys == 2 && handler.m_last_action == 2);
+		driver->key(1, key_button_b, key_state_down);
+		ifc.update();
+		INPUT_TEST_CHECK(handler.m_num_keys == 3 && handler.m_last_action == 3);
+		ifc.update();
+		INPUT_TEST_CHECK(handler.m_num_keys == 3);
+		ifc.pop_action_group(0, "Player", actions);
+		
+		// popped with the group
+		driver->key(0, key_e, key_state_up);
+		driver->key(0, key_e, key_state_down);
+		ifc.update();
+		INPUT_TEST_CHECK(handler.m_num_keys == 3);
+		return true;
+	}
+	
+	bool test_coalescing()
+	{
+		static const action actions[] = {
+			{ "Jump", 1, event_type_key },
+			{ "Turn", 2, event_type_axis },
+			{ "Look", 3, event_type_mouse },
+			{ 0, 0, event_type_invalid }
+		};
+		static const binding bindings[] = {
+			{ "Jump", make_keyboard_input(key_button_a, key_state_down) },
+			{ "Jump", make_keyboard_input(key_button_a, key_state_up) },
+			{ "Turn", make_axis_input(axis_lthumb_x) },
+			{ "Look", make_mouse_input() },
+			{ 0, make_empty_input() }
+		};
+		
+		interface ifc;
+		test_driver* driver = new test_driver();
+		ifc.add_driver(driver);
+		ifc.bind_device(0, driver->m_descs[0].id);
+		ifc.bind_device(0, driver->m_descs[1].id);
+		ifc.register_bindings("Player", bindings);
+		test_handler handler;
+		ifc.push_action_group(0, "Player", actions, &handler);
+		
+		// continuous input is dispatched once per update, key edges every time
+		driver->mouse(0, 3, 1);
+		driver->axis(1, axis_lthumb_x, 0.25f);
+		driver->key(1, key_button_a, key_state_down);
+		driver->mouse(0, -1, 4);
+		driver->axis(1, axis_lthumb_x, 0.75f);
+		driver->key(1, key_button_a, key_state_up);
+		driver->mouse(0, 5, 0);
+		ifc.update();
+		INPUT_TEST_CHECK(handler.m_num_keys == 2);
+		INPUT_TEST_CHECK(handler.m_num_mouse == 1);
+		INPUT_TEST_CHECK(handler.m_dx == 7 && handler.m_dy == 5);
+		INPUT_TEST_CHECK(handler.m_num_axes == 1);
+		INPUT_TEST_CHECK(handler.m_last_value == 0.75f);
+		
+		// nothing is left over for the next update
+		ifc.update();
+		INPUT_TEST_CHECK(handler.m_num_mouse == 1 && handler.m_num_axes == 1);
+		
+		// opting out dispatches every event again
+		ifc.pop_action_group(0, "Player", actions);
+		ifc.set_coalesce_policy("Look", coalesce_none);
+		ifc.push_action_group(0, "Player", actions, &handler);
+		driver->mouse(0, 1, 1);
+		driver->mouse(0, 2, 2);
+		ifc.update();
+		INPUT_TEST_CHECK(handler.m_num_mouse == 3);
+		INPUT_TEST_CHECK(handler.m_dx == 2);
+		
+		// popping the group delivers what was coalesced before it
+		driver->axis(1, axis_lthumb_x, -0.5f);
+		driver->update(&ifc);
+		INPUT_TEST_CHECK(handler.m_num_axes == 1);
+		ifc.pop_action_group(0, "Player", actions);
+		INPUT_TEST_CHECK(handler.m_num_axes == 2 && handler.m_last_value == -0.5f);
+		return true;
+	}
+
+	/// handler that takes its actions in batches
+	class batch_handler : public test_handler
+	{
+	public:
+		batch_handler() : m_num_batches(0) {}
+		virtual bool wants_batches() const { return true; }
+		virtual void handle_batch(const action_record* records, int count)
+		{
+			++m_num_batches;
+			m_records.insert(m_records.end(), records, records + count);
+		}
+		int m_num_batches;
+		std::vector<action_record> m_records;
+	};
+	
+	/// batched handler relying on the default adapter
+	class adapted_handler : public test_handler
+	{
+	public:
+		virtual bool wants_batches() const { return true; }
+	};
+
+	bool test_batched_dispatch()
+	{
+		static const action actions[] = {
+			{ "Jump", 1, event_type_key },
+			{ "Turn", 2, event_type_axis },
+			{ 0, 0, event_type_invalid }
+		};
+		static const binding bindings[] = {
+			{ "Jump", make_keyboard_input(key_button_a, key_state_down) },
+			{ "Turn", make_axis_input(axis_lthumb_x) },
+			{ 0, make_empty_input() }
+		};
+		
+		interface ifc;
+		test_driver* driver = new test_driver();
+		ifc.add_driver(driver);
+		ifc.bind_device(0, driver->m_descs[0].id);
+		ifc.bind_device(1, driver->m_descs[1].id);
+		ifc.register_bindings("Player", bindings);
+		
+		// one handler across two groups gets a single call per update, in dispatch order
+		batch_handler handler;
+		ifc.push_action_group(0, "Player", actions, &handler);
+		ifc.push_action_group(1, "Player", actions, &handler);
+		driver->key(0, key_button_a, key_state_down);
+		driver->axis(1, axis_lthumb_x, 0.5f);
+		driver->key(1, key_button_a, key_state_down);
+		ifc.update();
+		INPUT_TEST_CHECK(handler.m_num_batches == 1);
+		INPUT_TEST_CHECK(handler.m_num_keys == 0 && handler.m_num_axes == 0);
+		INPUT_TEST_CHECK(handler.m_records.size() == 3);
+		INPUT_TEST_CHECK(handler.m_records[0].kind == packet_type_keyboard && handler.m_records[0].action_id == 1);
+		INPUT_TEST_CHECK(handler.m_records[1].kind == packet_type_keyboard);
+		INPUT_TEST_CHECK(handler.m_records[2].kind == packet_type_axis && handler.m_records[2].value == 0.5f);
+		
+		// idle updates don't call the handler
+		ifc.update();
+		INPUT_TEST_CHECK(handler.m_num_batches == 1);
+		
+		// the last pop delivers anything still queued
+		driver->key(0, key_button_a, key_state_down);
+		driver->update(&ifc);
+		ifc.pop_action_group(1, "Player", actions);
+		INPUT_TEST_CHECK(handler.m_num_batches == 1);
+		ifc.pop_action_group(0, "Player", actions);
+		INPUT_TEST_CHECK(handler.m_num_batches == 2 && handler.m_records.size() == 4);
+		
+		// the default handle_batch forwards to the per event methods
+		adapted_handler adapted;
+		ifc.push_action_group(1, "Player", actions, &adapted);
+		driver->key(1, key_button_a, key_state_down);
+		driver->axis(1, axis_lthumb_x, -0.25f);
+		ifc.update();
+		INPUT_TEST_CHECK(adapted.m_num_keys == 1 && adapted.m_num_axes == 1);
+		INPUT_TEST_CHECK(adapted.m_last_value == -0.25f);
+		return true;
+	}
+
+	/// driver whose devices are plugged and unplugged by the test
+	class hotplug_driver : public driver_base
+	{
+	public:
+		hotplug_driver() : m_driver_id(0) {}
+		virtual bool initialise(int driver_id) { m_driver_id = driver_id; return true; }
+		virtual void update(event_handler* handler)
+		{
+			for(size_t i = 0; i < m_added.size(); ++i)
+				handler->handle_device_added(*find_device_desc(m_added[i]));
+			for(size_t i = 0; i < m_removed.size(); ++i)
+				handler->handle_device_removed(m_removed[i]);
+			for(size_t i = 0; i < m_keys.size(); ++i)
+				handler->handle_keyboard_event(m_keys[i], make_keyboard_packet(key_button_a, key_state_down));
+			m_added.clear();
+			m_removed.clear();
+			m_keys.clear();
+		}
+		virtual int get_num_devices() const { return 0; }
+		virtual const device_description* get_device_desc(int) const { return 0; }
+		virtual const device_description* find_device_desc(int device_id) const
+		{
+			int driver_id, num;
+			split_device_id(device_id, &driver_id, &num);
+			return driver_id == m_driver_id && num < 4 ? &m_descs[num] : 0;
+		}
+		int plug(int num)
+		{
+			device_description desc = { make_device_id(m_driver_id, num), device_gamepad, "Hotplug Pad", num };
+			m_descs[num] = desc;
+			m_added.push_back(desc.id);
+			return desc.id;
+		}
+		void unplug(int id) { m_removed.push_back(id); }
+		
+		int m_driver_id;
+		device_description m_descs[4];
+		std::vector<int> m_added;
+		std::vector<int> m_removed;
+		std::vector<int> m_keys;
+	};
+
+	bool test_hotplug()
+	{
+		static const action actions[] = {
+			{ "Jump", 1, event_type_key },
+			{ 0, 0, event_type_invalid }
+		};
+		static const binding bindings[] = {
+			{ "Jump", make_keyboard_input(key_button_a, key_state_down) },
+			{ 0, make_empty_input() }
+		};
+		
+		interface ifc;
+		hotplug_driver* driver = new hotplug_driver();
+		ifc.add_driver(driver);
+		ifc.register_bindings("Player", bindings);
+		test_handler handler;
+		ifc.push_action_group(2, "Player", actions, &handler);
+		INPUT_TEST_CHECK(ifc.get_devices().empty());
+		
+		// arrivals go through the ring and show up after the update
+		int a = driver->plug(0);
+		int b = driver->plug(1);
+		int c = driver->plug(2);
+		ifc.update();
+		INPUT_TEST_CHECK(ifc.get_devices().size() == 3);
+		INPUT_TEST_CHECK(ifc.find_device(b) && ifc.find_device(b)->index == 1);
+		INPUT_TEST_CHECK(strcmp(ifc.find_device(c)->name, "Hotplug Pad") == 0);
+		ifc.bind_device(2, a);
+		
+		// removal moves the last device into the hole
+		driver->unplug(a);
+		ifc.update();
+		INPUT_TEST_CHECK(ifc.get_devices().size() == 2);
+		INPUT_TEST_CHECK(ifc.find_device(a) == 0);
+		INPUT_TEST_CHECK(ifc.find_device(b)->id == b && ifc.find_device(c)->id == c);
+		
+		// the binding is kept so the device routes to the same group when it returns
+		driver->plug(0);
+		driver->m_keys.push_back(a);
+		ifc.update();
+		INPUT_TEST_CHECK(ifc.get_devices().size() == 3);
+		INPUT_TEST_CHECK(handler.m_num_keys == 1);
+		INPUT_TEST_CHECK(ifc.get_device_state(a).is_down(key_button_a));
+		
+		// removing a device with queued state doesn't leave it behind
+		driver->m_keys.push_back(c);
+		driver->unplug(c);
+		ifc.update();
+		ifc.update();
+		INPUT_TEST_CHECK(ifc.get_devices().size() == 2);
+		INPUT_TEST_CHECK(!ifc.get_device_state(c).is_down(key_button_a));
+		return true;
+	}
+
+	/// handler recording the order of its key actions along with the thread they ran on
+	class ordered_handler : public input_handler
+	{
+	public:
+		virtual bool handle_key(int action_id, key_type key, key_state)
+		{
+			m_keys.push_back(key);
+			m_actions.push_back(action_id);
+			m_threads.push_back(std::this_thread::get_id());
+			return true;
+		}
+		std::vector<int> m_keys;
+		std::vector<int> m_actions;
+		std::vector<std::thread::id> m_threads;
+	};
+
+	/// batched handler that only counts what it is given
+	class counting_batch_handler : public input_handler
+	{
+	public:
+		counting_batch_handler() : m_num_records(0) {}
+		virtual bool wants_batches() const { return true; }
+		virtual void handle_batch(const action_record*, int count) { m_num_records += count; }
+		int m_num_records;
+	};
+	
+	/// driver pushing packets with given timestamps straight into its ring
+	class timed_driver : public test_driver
+	{
+	public:
+		virtual void update(event_handler* handler)
+		{
+			// interface hands each driver its event ring
+			event_ring* ring = static_cast<event_ring*>(handler);
+			for(size_t i = 0; i < m_timed.size(); ++i)
+				ring->push(m_timed[i]);
+			m_timed.clear();
+		}
+		void key_at(tycho::core::int64 timestamp, int device_num, key_type k)
+		{
+			event_packet p;
+			p.timestamp = timestamp;
+			p.index = make_device_id(m_driver_id, device_num);
+			p.ptype = packet_type_keyboard;
+			p.keyboard = make_keyboard_packet(k, key_state_down);
+			m_timed.push_back(p);
+		}
+		std::vector<event_packet> m_timed;
+	};
+	
+	bool test_timestamp_merge()
+	{
+		static const action actions[] = {
+			{ "Fire", 1, event_type_key },
+			{ 0, 0, event_type_invalid }
+		};
+		static const binding bindings[] = {
+			{ "Fire", make_keyboard_input(key_button_a, key_state_down) },
+			{ "Fire", make_keyboard_input(key_button_mouse_left, key_state_down) },
+			{ 0, make_empty_input() }
+		};
+		interface ifc;
+		timed_driver* pads = new timed_driver();
+		timed_driver* mice = new timed_driver();
+		timed_driver* idle = new timed_driver();
+		ifc.add_driver(pads);
+		ifc.add_driver(idle);
+		ifc.add_driver(mice);
+		ifc.bind_device(0, pads->m_descs[1].id);
+		ifc.bind_device(0, mice->m_descs[0].id);
+		ifc.register_bindings("Player", bindings);
+		batch_handler handler;
+		ifc.push_action_group(0, "Player", actions, &handler);
+		
+		// runs from one driver interleave with the other, ties go to the driver added first
+		static const tycho::core::int64 pad_times[] = { 10, 30, 50, 51, 52, 90 };
+		static const tycho::core::int64 mouse_times[] = { 20, 40, 41, 60, 90, 100 };
+		for(int i = 0; i < 6; ++i)
+		{
+			pads->key_at(pad_times[i], 1, key_button_a);
+			mice->key_at(mouse_times[i], 0, key_button_mouse_left);
+		}
+		ifc.update();
+		static const tycho::core::int64 expected[] = { 10, 20, 30, 40, 41, 50, 51, 52, 60, 90, 90, 100 };
+		INPUT_TEST_CHECK(handler.m_records.size() == 12);
+		for(int i = 0; i < 12; ++i)
+			INPUT_TEST_CHECK(handler.m_records[i].timestamp == expected[i]);
+		INPUT_TEST_CHECK(handler.m_records[9].keyboard.key == key_button_a);
+		INPUT_TEST_CHECK(handler.m_records[10].keyboard.key == key_button_mouse_left);
+		
+		// live timestamps are nanoseconds from a monotonic clock
+		tycho::core::int64 t0 = get_timestamp();
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		INPUT_TEST_CHECK(get_timestamp() - t0 >= 2000000);
+		ifc.pop_action_group(0, "Player", actions);
+		return true;
+	}
+	
+	bool test_zero_allocations()
+	{
+		static const action player_actions[] = {
+			{ "Jump", 1, event_type_key },
+			{ "Turn", 2, event_type_axis },
+			{ "Look", 3, event_type_mouse },
+			{ 0, 0, event_type_invalid }
+		};
+		static const action menu_actions[] = {
+			{ "Select", 4, event_type_key },
+			{ 0, 0, event_type_invalid }
+		};
+		static const binding player_bindings[] = {
+			{ "Jump", make_keyboard_input(key_button_a, key_state_down) },
+			{ "Turn", make_axis_input(axis_lthumb_x) },
+			{ "Look", make_mouse_input() },
+			{ 0, make_empty_input() }
+		};
+		static const binding menu_bindings[] = {
+			{ "Select", make_keyboard_input(key_button_a, key_state_down) },
+			{ 0, make_empty_input() }
+		};
+		
+		interface ifc;
+		test_driver* driver = new test_driver();
+		ifc.add_driver(driver);
+		ifc.bind_device(0, driver->m_descs[0].id);
+		ifc.bind_device(1, driver->m_descs[1].id);
+		ifc.register_bindings("a binding set name too long for the small string optimisation", player_bindings);
+		ifc.register_bindings("Menu", menu_bindings);
+		test_handler handler;
+		counting_batch_handler batched;
+		ifc.push_action_group(0, "a binding set name too long for the small string optimisation", player_actions, &handler);
+		
+		// switching context, dispatching, coalescing, batching and publishing state every frame
+		struct frame
+		{
+			static void run(interface& ifc, test_driver* driver, test_handler& handler, counting_batch_handler& batched)
+			{
+				ifc.push_action_group(1, "Menu", menu_actions, &batched);
+				for(int i = 0; i < 8; ++i)
+				{
+					driver->key(0, key_button_a, (i & 1) ? key_state_up : key_state_down);
+					driver->key(1, key_button_a, (i & 1) ? key_state_up : key_state_down);
+					driver->mouse(0, i, -i);
+					driver->axis(1, axis_lthumb_x, i * 0.1f);
+				}
+				ifc.update();
+				ifc.pop_action_group(1, "Menu", menu_actions);
+				ifc.push_action_group(0, "Menu", menu_actions, &handler);
+				driver->key(0, key_button_a, key_state_down);
+				ifc.update();
+				ifc.pop_action_group(0, "Menu", menu_actions);
+			}
+		};
+		
+		// the first frames size everything to its steady state
+		for(int i = 0; i < 4; ++i)
+			frame::run(ifc, driver, handler, batched);
+		int num_keys = handler.m_num_keys;
+		int num_records = batched.m_num_records;
+		g_num_allocations = 0;
+		g_count_allocations = true;
+		for(int i = 0; i < 100; ++i)
+			frame::run(ifc, driver, handler, batched);
+		g_count_allocations = false;
+		INPUT_TEST_CHECK(g_num_allocations == 0);
+		INPUT_TEST_CHECK(handler.m_num_keys > num_keys);
+		INPUT_TEST_CHECK(batched.m_num_records > num_records);
+		ifc.pop_action_group(0, "a binding set name too long for the small string optimisation", player_actions);
+		
+		// objects the interface creates come from the allocator it is given
+		alignas(16) static char memory[64 * 1024];
+		arena_allocator arena(memory, sizeof(memory));
+		{
+			interface arena_ifc(&arena);
+			arena_ifc.add_driver(new test_driver());
+			size_t used = arena.get_used();
+			INPUT_TEST_CHECK(used >= sizeof(event_ring));
+			arena_ifc.register_bindings("Menu", menu_bindings);
+			INPUT_TEST_CHECK(arena.get_used() >= used + sizeof(binding_set));
+			INPUT_TEST_CHECK(arena_ifc.get_devices().size() == 2);
+		}
+		return true;
+	}
+	
+	bool test_parallel_dispatch()
+	{
+		static const action actions[] = {
+			{ "Up", 1, event_type_key },
+			{ "Down", 2, event_type_key },
+			{ "Left", 3, event_type_key },
+			{ 0, 0, event_type_invalid }
+		};
+		static const binding bindings[] = {
+			{ "Up", make_keyboard_input(key_button_dpad_up, key_state_down) },
+			{ "Down", make_keyboard_input(key_button_dpad_down, key_state_down) },
+			{ "Left", make_keyboard_input(key_button_dpad_left, key_state_down) },
+			{ 0, make_empty_input() }
+		};
+		static const key_type keys[] = { key_button_dpad_up, key_button_dpad_down, key_button_dpad_left };
+		const int NumGroups = 4;
+		
+		thread_pool pool(3);
+		interface ifc;
+		ifc.set_job_system(&pool);
+		hotplug_driver* driver = new hotplug_driver();
+		ifc.add_driver(driver);
+		ifc.register_bindings("Player", bindings);
+		ordered_handler handlers[NumGroups];
+		batch_handler batched;
+		int ids[NumGroups];
+		for(int g = 0; g < NumGroups; ++g)
+		{
+			ids[g] = driver->plug(g);
+			ifc.push_action_group(g, "Player", actions, &handlers[g]);
+		}
+		ifc.update();
+		for(int g = 0; g < NumGroups; ++g)
+			ifc.bind_device(g, ids[g]);
+		
+		// a batched handler shared by every group alongside the per group handlers
+		static const action shared_actions[] = {
+			{ "Shared", 9, event_type_key },
+			{ 0, 0, event_type_invalid }
+		};
+		static const binding shared_bindings[] = {
+			{ "Shared", make_keyboard_input(key_button_start, key_state_down) },
+			{ 0, make_empty_input() }
+		};
+		ifc.register_bindings("Shared", shared_bindings);
+		for(int g = 0; g < NumGroups; ++g)
+			ifc.push_action_group(g, "Shared", shared_actions, &batched);
+		
+		// each group sees its own events in the order they were generated
+		const int NumFrames = 20;
+		for(int f = 0; f < NumFrames; ++f)
+		{
+			for(int e = 0; e < 30; ++e)
+			{
+				for(int g = 0; g < NumGroups; ++g)
+				{
+					ifc.handle_keyboard_event(ids[g], make_keyboard_packet(keys[(e + g + f) % 3], key_state_down));
+					if(e == 0)
+						ifc.handle_keyboard_event(ids[g], make_keyboard_packet(key_button_start, key_state_down));
+				}
+			}
+			ifc.update();
+			for(int g = 0; g < NumGroups; ++g)
+				INPUT_TEST_CHECK(ifc.get_group_state(g).was_pressed_this_frame(key_button_start));
+		}
+		for(int g = 0; g < NumGroups; ++g)
+		{
+			const ordered_handler& h = handlers[g];
+			INPUT_TEST_CHECK(h.m_keys.size() == NumFrames * 30);
+			for(int f = 0; f < NumFrames; ++f)
+			{
+				for(int e = 0; e < 30; ++e)
+				{
+					int i = f * 30 + e;
+					INPUT_TEST_CHECK(h.m_keys[i] == keys[(e + g + f) % 3]);
+					INPUT_TEST_CHECK(h.m_actions[i] == 1 + (e + g + f) % 3);
+				}
+			}
+		}
+		INPUT_TEST_CHECK(batched.m_num_batches == NumFrames);
+		INPUT_TEST_CHECK((int)batched.m_records.size() == NumFrames * NumGroups);
+		
+		// switching back to serial dispatch runs on the calling thread
+		ifc.set_job_system(0);
+		handlers[0].m_threads.clear();
+		ifc.handle_keyboard_event(ids[0], make_keyboard_packet(key_button_dpad_up, key_state_down));
+		ifc.update();
+		INPUT_TEST_CHECK(handlers[0].m_threads.size() == 1 && handlers[0].m_threads[0] == std::this_thread::get_id());
+		return true;
+	}
+
+	bool test_record_replay()
+	{
+		static const action actions[] = {
+			{ "Jump", 1, event_type_key },
+			{ "Turn", 2, event_type_axis },
+			{ 0, 0, event_type_invalid }
+		};
+		static const binding bindings[] = {
+			{ "Jump", make_keyboard_input(key_button_a, key_state_down) },
+			{ "Turn", make_axis_input(axis_lthumb_x) },
+			{ 0, make_empty_input() }
+		};
+		const char* path = "input_test_recording.bin";
+		
+		// record two frames of input
+		{
+			interface ifc;
+			test_driver* driver = new test_driver();
+			ifc.add_driver(driver);
+			INPUT_TEST_CHECK(ifc.start_recording(path));
+			driver->key(1, key_button_a, key_state_down);
+			driver->axis(1, axis_lthumb_x, 0.25f);
+			ifc.update();
+			driver->axis(1, axis_lthumb_x, -1.0f);
+			ifc.update();
+			ifc.stop_recording();
+		}
+		
+		// play it back one frame at a time
+		interface ifc;
+		replay_driver* replay = new replay_driver(path, replay_driver::replay_fast);
+		ifc.add_driver(replay);
+		INPUT_TEST_CHECK(replay->get_num_events() == 3);
+		INPUT_TEST_CHECK(ifc.get_devices().size() == 2);
+		const device_description& pad = ifc.get_devices()[1];
+		INPUT_TEST_CHECK(pad.id == make_device_id(0, 1));
+		INPUT_TEST_CHECK(pad.type == device_xenoncontroller);
+		INPUT_TEST_CHECK(strcmp(pad.name, "Test Pad") == 0);
+		
+		ifc.bind_device(0, pad.id);
+		ifc.register_bindings("Player", bindings);
+		test_handler handler;
+		ifc.push_action_group(0, "Player", actions, &handler);
+		ifc.update();
+		INPUT_TEST_CHECK(handler.m_num_keys == 1 && handler.m_num_axes == 1);
+		INPUT_TEST_CHECK(handler.m_last_value == 0.25f);
+		INPUT_TEST_CHECK(!replay->is_finished());
+		ifc.update();
+		INPUT_TEST_CHECK(handler.m_num_axes == 2 && handler.m_last_value == -1.0f);
+		INPUT_TEST_CHECK(replay->is_finished());
+		
+		// a pad plugged in and out while recording comes and goes at the same point in the replay,
+		// its id names the second driver while recording, not the replay driver
+		int late;
+		{
+			interface rec;
+			rec.add_driver(new test_driver());
+			hotplug_driver* driver = new hotplug_driver();
+			rec.add_driver(driver);
+			INPUT_TEST_CHECK(rec.start_recording(path));
+			late = driver->plug(1);
+			INPUT_TEST_CHECK(late == make_device_id(1, 1));
+			rec.update();
+			driver->m_keys.push_back(late);
+			rec.update();
+			driver->unplug(late);
+			rec.update();
+			rec.stop_recording();
+		}
+		{
+			interface play;
+			replay_driver* late_replay = new replay_driver(path, replay_driver::replay_fast);
+			play.add_driver(late_replay);
+			INPUT_TEST_CHECK(late_replay->get_num_events() == 3);
+			INPUT_TEST_CHECK(play.get_devices().size() == 2 && !play.find_device(late));
+			play.bind_device(1, late);
+			play.update();
+			INPUT_TEST_CHECK(play.find_device(late) && play.find_device(late)->type == device_gamepad);
+			INPUT_TEST_CHECK(strcmp(play.find_device(late)->name, "Hotplug Pad") == 0);
+			play.update();
+			INPUT_TEST_CHECK(play.get_device_state(late).is_down(key_button_a) && play.is_down(1, key_button_a));
+			play.update();
+			INPUT_TEST_CHECK(!play.find_device(late) && late_replay->is_finished());
+		}
+		
+		// a failed resize leaves the file open so it can still be trimmed and closed
+		{
+			mapped_file f;
+			INPUT_TEST_CHECK(f.open_write(path, 64));
+			INPUT_TEST_CHECK(!f.resize((size_t)1 << 62));
+			INPUT_TEST_CHECK(f.is_open() && !f.is_mapped());
+			INPUT_TEST_CHECK(f.resize(16) && f.is_mapped());
+#if defined(__linux__)
+			// growing allocates the space rather than leaving a sparse file
+			INPUT_TEST_CHECK(f.resize(1 << 20));
+			struct stat st;
+			INPUT_TEST_CHECK(stat(path, &st) == 0 && st.st_size == 1 << 20 && (size_t)st.st_blocks * 512 >= (size_t)1 << 20);
+#endif
+			f.close();
+			INPUT_TEST_CHECK(!f.is_open());
+		}
+		remove(path);
+		return true;
+	}
+
+	bool test_input_stream()
+	{
+		// every kind of record round trips, timestamps are exact at 1ns resolution
+		const int pad = make_device_id(3, 1);
+		const int mouse = make_device_id(3, 2);
+		std::vector<event_packet> in;
+		event_packet p;
+		p.timestamp = 1000000000;
+		p.index = pad;
+		p.ptype = packet_type_device_added;
+		p.device.type = device_gamepad;
+		p.device.index = 1;
+		in.push_back(p);
+		p.ptype = packet_type_keyboard;
+		p.keyboard = make_keyboard_packet(key_button_a, key_state_down);
+		in.push_back(p);
+		p.timestamp += 1234567;
+		p.keyboard = make_keyboard_packet(key_button_a, key_state_up);
+		in.push_back(p);
+		p.ptype = packet_type_axis;
+		p.axis = make_axis_packet(axis_lthumb_x, -1.0f);
+		in.push_back(p);
+		p.axis = make_axis_packet(axis_rtrigger_x, 0.25f);
+		in.push_back(p);
+		p.index = mouse;
+		p.timestamp -= 10;	// out of order timestamps still round trip
+		p.ptype = packet_type_mouse;
+		p.mouse = make_mouse_packet(3, -200000);
+		in.push_back(p);
+		p.mouse = make_mouse_packet(0, 5);
+		in.push_back(p);
+		p.index = pad;
+		p.ptype = packet_type_device_removed;
+		p.device.type = device_unknown;
+		p.device.index = -1;
+		in.push_back(p);
+		
+		stream_encoder enc(1);
+		for(size_t i = 0; i < in.size(); ++i)
+			enc.encode(in[i]);
+		INPUT_TEST_CHECK(enc.get_num_events() == in.size());
+		
+		// a single feed, then a byte at a time
+		for(int bytewise = 0; bytewise < 2; ++bytewise)
+		{
+			stream_decoder dec;
+			event_packet out[16];
+			int n = 0;
+			if(bytewise)
+			{
+				for(size_t i = 0; i < enc.get_size(); ++i)
+				{
+					dec.feed(enc.get_data() + i, 1);
+					n += dec.decode(out + n, 16 - n);
+				}
+			}
+			else
+			{
+				dec.feed(enc.get_data(), enc.get_size());
+				n = dec.decode(out, 16);
+			}
+			INPUT_TEST_CHECK(dec.is_valid() && dec.get_pending() == 0);
+			INPUT_TEST_CHECK(n == (int)in.size());
+			for(int i = 0; i < n; ++i)
+			{
+				INPUT_TEST_CHECK(out[i].timestamp == in[i].timestamp);
+				INPUT_TEST_CHECK(out[i].index == in[i].index);
+				INPUT_TEST_CHECK(out[i].ptype == in[i].ptype);
+			}
+			INPUT_TEST_CHECK(out[0].device.type == device_gamepad && out[0].device.index == 1);
+			INPUT_TEST_CHECK(out[1].keyboard.key == key_button_a && out[1].keyboard.state == key_state_down);
+			INPUT_TEST_CHECK(out[2].keyboard.state == key_state_up);
+			INPUT_TEST_CHECK(out[3].axis.axis == axis_lthumb_x && out[3].axis.value == -1.0f);
+			INPUT_TEST_CHECK(out[4].axis.axis == axis_rtrigger_x && fabsf(out[4].axis.value - 0.25f) < 1.0f / stream_format::AxisScale);
+			INPUT_TEST_CHECK(out[5].mouse.dx == 3 && out[5].mouse.dy == -200000);
+			INPUT_TEST_CHECK(out[6].mouse.dx == 0 && out[6].mouse.dy == 5);
+		}
+		
+		// a run of key presses 1ms apart at the default resolution
+		stream_encoder keys;
+		size_t header_size = keys.get_size();
+		p.index = pad;
+		p.ptype = packet_type_keyboard;
+		for(int i = 0; i < 1000; ++i)
+		{
+			p.timestamp += 1000000;
+			p.keyboard = make_keyboard_packet(key_button_a, (i & 1) ? key_state_up : key_state_down);
+			keys.encode(p);
+		}
+		INPUT_TEST_CHECK(keys.get_size() - header_size <= 1000 * 4 + 8);
+		
+		// anything else is rejected
+		stream_decoder bad;
+		bad.feed("not an input stream", 19);
+		event_packet out;
+		INPUT_TEST_CHECK(bad.decode(&out, 1) == 0 && !bad.is_valid());
+		
+		// as are records with values out of range, whether or not the record is near the end
+		// of what has been fed. Each follows a good key record from the previous device.
+		const tycho::core::uint8 same = stream_format::SameDevice | stream_format::SameTime;
+		const tycho::core::uint8 good[] = { (tycho::core::uint8)(stream_format::kind_key | same | (key_state_down << stream_format::PayloadShift)), (tycho::core::uint8)key_button_a };
+		const tycho::core::uint8 malformed[][4] = {
+			{ (tycho::core::uint8)(stream_format::kind_key | same | (key_state_down << stream_format::PayloadShift)), 0xff },
+			{ (tycho::core::uint8)(stream_format::kind_key | same | (key_state_down << stream_format::PayloadShift)), (tycho::core::uint8)key_invalid },
+			{ (tycho::core::uint8)(stream_format::kind_key | same | (3 << stream_format::PayloadShift)), (tycho::core::uint8)key_button_a },
+			{ (tycho::core::uint8)(stream_format::kind_key | same), (tycho::core::uint8)key_button_a },
+			{ (tycho::core::uint8)(stream_format::kind_axis | same | (7 << stream_format::PayloadShift)), 0, 0 },
+			{ (tycho::core::uint8)(stream_format::kind_axis | same), 0, 0 },
+			{ (tycho::core::uint8)(stream_format::kind_device_added | same), 200, 0, 0 }
+		};
+		stream_encoder header;
+		for(int padded = 0; padded < 2; ++padded)
+		{
+			for(size_t i = 0; i < sizeof(malformed) / sizeof(malformed[0]); ++i)
+			{
+				stream_decoder dec;
+				dec.feed(header.get_data(), header.get_size());
+				dec.feed(good, sizeof(good));
+				dec.feed(malformed[i], sizeof(malformed[i]));
+				for(int j = 0; padded && j < 64; ++j)
+					dec.feed(good, sizeof(good));
+				event_packet decoded[4];
+				INPUT_TEST_CHECK(dec.decode(decoded, 4) == 1 && !dec.is_valid());
+				INPUT_TEST_CHECK(dec.decode(decoded, 4) == 0);
+			}
+		}
+		
+		// as a driver the stream's devices get ids of their own next to the local ones
+		static const action actions[] = {
+			{ "Jump", 1, event_type_key },
+			{ 0, 0, event_type_invalid }
+		};
+		static const binding bindings[] = {
+			{ "Jump", make_keyboard_input(key_button_a, key_state_down) },
+			{ 0, make_empty_input() }
+		};
+		interface ifc;
+		ifc.add_driver(new test_driver());
+		stream_decoder* remote = new stream_decoder();
+		ifc.add_driver(remote);
+		ifc.register_bindings("Player", bindings);
+		test_handler handler;
+		ifc.push_action_group(0, "Player", actions, &handler);
+		
+		stream_encoder sender;
+		device_description desc = { make_device_id(0, 1), device_xenoncontroller, "Remote Pad", 0 };
+		sender.handle_device_added(desc);
+		remote->feed(sender.get_data(), sender.get_size());
+		sender.clear();
+		ifc.update();
+		INPUT_TEST_CHECK(ifc.get_devices().size() == 3);
+		const device_description* d = ifc.find_device(make_device_id(1, 0));
+		INPUT_TEST_CHECK(d && d->type == device_xenoncontroller && strcmp(d->name, "Remote Pad") == 0);
+		
+		ifc.bind_device(0, make_device_id(1, 0));
+		sender.handle_keyboard_event(desc.id, make_keyboard_packet(key_button_a, key_state_down));
+		sender.handle_device_removed(desc.id);
+		remote->feed(sender.get_data(), sender.get_size());
+		ifc.update();
+		INPUT_TEST_CHECK(handler.m_num_keys == 1);
+		INPUT_TEST_CHECK(ifc.get_devices().size() == 2);
+		INPUT_TEST_CHECK(remote->get_num_devices() == 0);
+		
+		// a device of an unknown type never reaches the interface
+		sender.clear();
+		remote->feed(sender.get_data(), sender.get_size());
+		remote->feed(malformed[6], sizeof(malformed[6]));
+		ifc.update();
+		INPUT_TEST_CHECK(!remote->is_valid());
+		INPUT_TEST_CHECK(ifc.get_devices().size() == 2 && remote->get_num_devices() == 0);
+		return true;
+	}
+	
+	bool test_polled_state()
+	{
+		interface ifc;
+		test_driver* driver = new test_driver();
+		ifc.add_driver(driver);
+		int kb = driver->m_descs[0].id;
+		int pad = driver->m_descs[1].id;
+		ifc.bind_device(2, pad);
+		
+		driver->key(1, key_button_a, key_state_down);
+		driver->axis(1, axis_rthumb_y, -0.75f);
+		driver->key(0, key_w, key_state_down);
+		ifc.update();
+		INPUT_TEST_CHECK(ifc.is_down(2, key_button_a));
+		INPUT_TEST_CHECK(ifc.was_pressed_this_frame(2, key_button_a));
+		INPUT_TEST_CHECK(ifc.axis_value(2, axis_rthumb_y) == -0.75f);
+		INPUT_TEST_CHECK(!ifc.is_down(2, key_w));
+		INPUT_TEST_CHECK(ifc.get_device_state(kb).is_down(key_w));
+		INPUT_TEST_CHECK(ifc.get_device_state(pad).is_down(key_button_a));
+		INPUT_TEST_CHECK(!ifc.get_device_state(make_device_id(9, 9)).is_down(key_w));
+		
+		// held keys stay down, single frame state clears
+		ifc.update();
+		INPUT_TEST_CHECK(ifc.is_down(2, key_button_a));
+		INPUT_TEST_CHECK(!ifc.was_pressed_this_frame(2, key_button_a));
+		INPUT_TEST_CHECK(ifc.axis_value(2, axis_rthumb_y) == -0.75f);
+		
+		// a tap inside a single frame is still seen
+		driver->key(1, key_button_a, key_state_up);
+		driver->key(1, key_button_b, key_state_down);
+		driver->key(1, key_button_b, key_state_up);
+		ifc.update();
+		INPUT_TEST_CHECK(!ifc.is_down(2, key_button_a));
+		INPUT_TEST_CHECK(ifc.was_released_this_frame(2, key_button_a));
+		INPUT_TEST_CHECK(!ifc.is_down(2, key_button_b));
+		INPUT_TEST_CHECK(ifc.was_pressed_this_frame(2, key_button_b));
+		INPUT_TEST_CHECK(ifc.was_released_this_frame(2, key_button_b));
+		ifc.update();
+		INPUT_TEST_CHECK(!ifc.was_pressed_this_frame(2, key_button_b));
+		INPUT_TEST_CHECK(!ifc.was_released_this_frame(2, key_button_a));
+		
+		// a key held on two devices in a group stays held until both let go
+		ifc.bind_device(2, kb);
+		driver->key(0, key_button_x, key_state_down);
+		ifc.update();
+		driver->key(1, key_button_x, key_state_down);
+		ifc.update();
+		INPUT_TEST_CHECK(ifc.is_down(2, key_button_x) && !ifc.was_pressed_this_frame(2, key_button_x));
+		driver->key(0, key_button_x, key_state_up);
+		ifc.update();
+		INPUT_TEST_CHECK(ifc.is_down(2, key_button_x) && !ifc.was_released_this_frame(2, key_button_x));
+		INPUT_TEST_CHECK(!ifc.get_device_state(kb).is_down(key_button_x));
+		driver->key(1, key_button_x, key_state_up);
+		ifc.update();
+		INPUT_TEST_CHECK(!ifc.is_down(2, key_button_x) && ifc.was_released_this_frame(2, key_button_x));
+		
+		// a device leaving the group takes its held keys with it, keys held before it joined
+		// were never the group's
+		driver->key(0, key_button_y, key_state_down);
+		driver->key(1, key_button_x, key_state_down);
+		driver->key(0, key_button_x, key_state_down);
+		ifc.update();
+		ifc.unbind_device(kb);
+		ifc.update();
+		INPUT_TEST_CHECK(!ifc.is_down(2, key_button_y) && ifc.was_released_this_frame(2, key_button_y));
+		INPUT_TEST_CHECK(ifc.is_down(2, key_button_x) && !ifc.was_released_this_frame(2, key_button_x));
+		INPUT_TEST_CHECK(!ifc.was_released_this_frame(2, key_w));
+		return true;
+	}
+	
+	bool test_many_groups()
+	{
+		// a server with a bot per group, and more devices in a group than there used to be room for
+		const int num_groups = 512;
+		interface ifc(0, num_groups);
+		INPUT_TEST_CHECK(ifc.get_num_groups() == num_groups);
+		for(int i = 0; i < num_groups + 12; ++i)
+		{
+			device_description desc = { make_device_id(0, i), device_gamepad, "Bot Pad", i };
+			ifc.handle_device_added(desc);
+			INPUT_TEST_CHECK(ifc.bind_device(i < num_groups ? i : 0, desc.id));
+		}
+		for(int i = 0; i < num_groups + 12; ++i)
+			ifc.handle_keyboard_event(make_device_id(0, i), make_keyboard_packet(i & 1 ? key_button_b : key_button_a, key_state_down));
+		ifc.update();
+		INPUT_TEST_CHECK(ifc.is_down(0, key_button_a) && ifc.is_down(0, key_button_b));
+		INPUT_TEST_CHECK(ifc.is_down(num_groups - 1, key_button_b) && !ifc.is_down(num_groups - 1, key_button_a));
+		INPUT_TEST_CHECK(ifc.is_down(300, key_button_a) && !ifc.is_down(300, key_button_b));
+		
+		// moving devices between groups keeps the others in place
+		ifc.unbind_device(make_device_id(0, num_groups + 3));
+		INPUT_TEST_CHECK(ifc.bind_device(7, make_device_id(0, num_groups + 5)));
+		ifc.handle_keyboard_event(make_device_id(0, num_groups + 3), make_keyboard_packet(key_button_x, key_state_down));
+		ifc.handle_keyboard_event(make_device_id(0, num_groups + 5), make_keyboard_packet(key_button_y, key_state_down));
+		ifc.handle_keyboard_event(make_device_id(0, num_groups + 11), make_keyboard_packet(key_button_start, key_state_down));
+		ifc.update();
+		INPUT_TEST_CHECK(!ifc.is_down(0, key_button_x) && !ifc.is_down(0, key_button_y));
+		INPUT_TEST_CHECK(ifc.is_down(7, key_button_y));
+		INPUT_TEST_CHECK(ifc.is_down(0, key_button_start));
+		return true;
+	}
+	
+	bool test_input_history()
+	{
+		interface ifc;
+		test_driver* driver = new test_driver();
+		ifc.add_driver(driver);
+		ifc.bind_device(1, driver->m_descs[1].id);
+		input_history history(ifc.get_num_groups(), 6);
+		INPUT_TEST_CHECK(history.get_capacity() == 8);
+		INPUT_TEST_CHECK(!history.find(0, 1));
+		
+		// tick 0 has a press and an axis, tick 1 only holds them
+		driver->key(1, key_button_a, key_state_down);
+		driver->axis(1, axis_lthumb_x, -0.5f);
+		ifc.update();
+		INPUT_TEST_CHECK(history.snapshot(ifc) == 0);
+		ifc.update();
+		INPUT_TEST_CHECK(history.snapshot(ifc) == 1);
+		const tick_input* t0 = history.find(0, 1);
+		const tick_input* t1 = history.find(1, 1);
+		INPUT_TEST_CHECK(t0 && t0->is_down(key_button_a) && t0->was_pressed_this_frame(key_button_a));
+		INPUT_TEST_CHECK(t0->axis_value(axis_lthumb_x) > -0.5001f && t0->axis_value(axis_lthumb_x) < -0.4999f);
+		INPUT_TEST_CHECK(t1 && t1->is_down(key_button_a) && !t1->was_pressed_this_frame(key_button_a));
+		INPUT_TEST_CHECK(!history.find(0, 0)->is_down(key_button_a));
+		INPUT_TEST_CHECK(history.get_hash(0) != history.get_hash(1));
+		
+		// ticks without a snapshot predict held input, a late remote packet then corrects one
+		int tick = history.advance();
+		INPUT_TEST_CHECK(history.find(tick, 1)->is_down(key_button_a) && history.find(tick, 1)->axis_value(axis_lthumb_x) < 0);
+		tycho::core::uint64 predicted = history.get_hash(tick);
+		tick_input remote = *history.find(tick, 0);
+		frame_state::set(remote.down, key_button_b);
+		frame_state::set(remote.pressed, key_button_b);
+		remote.mouse_dx = -3;
+		INPUT_TEST_CHECK(remote != *history.find(tick, 0));
+		INPUT_TEST_CHECK(history.overwrite(tick, 0, remote));
+		INPUT_TEST_CHECK(*history.find(tick, 0) == remote && history.get_hash(tick) != predicted);
+		
+		// the hash kept up by overwrite is the one a peer with the same input computes
+		input_history peer(ifc.get_num_groups(), 8);
+		peer.reset(tick);
+		peer.advance();
+		for(int g = 0; g < ifc.get_num_groups(); ++g)
+			peer.overwrite(tick, g, *history.find(tick, g));
+		INPUT_TEST_CHECK(peer.get_hash(tick) == history.get_hash(tick));
+		INPUT_TEST_CHECK(!peer.contains(tick - 1) && !peer.overwrite(tick + 1, 0, remote));
+		
+		// correcting a tick leaves the ones predicted after it alone until they are re-predicted
+		history.advance();
+		int newest = history.advance();
+		tick_input corrected = remote;
+		frame_state::set(corrected.down, key_button_x);
+		INPUT_TEST_CHECK(history.overwrite(tick, 0, corrected));
+		INPUT_TEST_CHECK(!history.find(newest, 0)->is_down(key_button_x));
+		INPUT_TEST_CHECK(history.repredict(tick, 0) && !history.repredict(newest + 1, 0));
+		for(int t = tick + 1; t <= newest; ++t)
+		{
+			const tick_input* in = history.find(t, 0);
+			INPUT_TEST_CHECK(in->is_down(key_button_x) && in->is_down(key_button_b));
+			INPUT_TEST_CHECK(!in->was_pressed_this_frame(key_button_b) && in->mouse_dx == 0);
+			INPUT_TEST_CHECK(history.find(t, 1)->is_down(key_button_a));
+		}
+		input_history check(ifc.get_num_groups(), 8);
+		check.reset(newest);
+		check.advance();
+		for(int g = 0; g < ifc.get_num_groups(); ++g)
+			check.overwrite(newest, g, *history.find(newest, g));
+		INPUT_TEST_CHECK(check.get_hash(newest) == history.get_hash(newest));
+		
+		// re-simulating the window reads and rewrites without allocating
+		for(int i = 0; i < 4; ++i)
+			history.advance();
+		g_num_allocations = 0;
+		g_count_allocations = true;
+		int buttons = 0;
+		for(int t = history.get_oldest_tick(); t <= history.get_newest_tick(); ++t)
+		{
+			tick_input in = *history.find(t, 1);
+			buttons += in.is_down(key_button_a);
+			history.overwrite(t, 1, in);
+		}
+		g_count_allocations = false;
+		INPUT_TEST_CHECK(g_num_allocations == 0);
+		INPUT_TEST_CHECK(buttons == 8);
+		INPUT_TEST_CHECK(history.get_oldest_tick() == 1 && !history.find(0, 1));
+		return true;
+	}
+	
+	/// event handler that keeps every event it is given
+	class packet_collector : public driver_base::event_handler
+	{
+	public:
+		virtual void handle_mouse_event(int device_id, const mouse_packet& mouse)
+			{ event_packet p; p.timestamp = 0; p.index = device_id; p.ptype = packet_type_mouse; p.mouse = mouse; m_packets.push_back(p); }
+		virtual void handle_keyboard_event(int device_id, const keyboard_packet& keyboard)
+			{ event_packet p; p.timestamp = 0; p.index = device_id; p.ptype = packet_type_keyboard; p.keyboard = keyboard; m_packets.push_back(p); }
+		virtual void handle_axis_event(int device_id, const axis_packet& axis)
+			{ event_packet p; p.timestamp = 0; p.index = device_id; p.ptype = packet_type_axis; p.axis = axis; m_packets.push_back(p); }
+		std::vector<event_packet> m_packets;
+	};
+
+	bool test_gamepad_diff()
+	{
+		gamepad_state prev = make_gamepad_state();
+		gamepad_state cur = make_gamepad_state();
+		gamepad_diff d = diff_gamepad_state(prev, cur);
+		INPUT_TEST_CHECK(d.pressed == 0 && d.released == 0 && d.axes == 0);
+		
+		prev.buttons = gamepad_a | gamepad_dpad_left;
+		cur.buttons = gamepad_a | gamepad_y | gamepad_start;
+		cur.axes[gamepad_axis_lthumb_x] = 32767;
+		cur.axes[gamepad_axis_rtrigger] = 255;
+		d = diff_gamepad_state(prev, cur);
+		INPUT_TEST_CHECK(d.pressed == (gamepad_y | gamepad_start));
+		INPUT_TEST_CHECK(d.released == gamepad_dpad_left);
+		INPUT_TEST_CHECK(d.axes == ((1u << gamepad_axis_lthumb_x) | (1u << gamepad_axis_rtrigger)));
+		
+		packet_collector collector;
+		emit_gamepad_events(7, prev, cur, gamepad_config::make_default(), &collector);
+		const std::vector<event_packet>& p = collector.m_packets;
+		INPUT_TEST_CHECK(p.size() == 5);
+		INPUT_TEST_CHECK(p[0].keyboard.key == key_button_dpad_left && p[0].keyboard.state == key_state_up);
+		INPUT_TEST_CHECK(p[1].keyboard.key == key_button_start && p[1].keyboard.state == key_state_down);
+		INPUT_TEST_CHECK(p[2].keyboard.key == key_button_y && p[2].keyboard.state == key_state_down);
+		INPUT_TEST_CHECK(p[3].ptype == packet_type_axis && p[3].axis.axis == axis_lthumb_x);
+		INPUT_TEST_CHECK(p[3].axis.value > 0.99f && p[3].axis.value <= 1.0f);
+		INPUT_TEST_CHECK(p[4].axis.axis == axis_rtrigger_x && p[4].axis.value == 1.0f);
+		INPUT_TEST_CHECK(p[0].index == 7);
+		
+		// inside the deadzone normalises to zero
+		INPUT_TEST_CHECK(normalise_gamepad_axis(gamepad_axis_lthumb_y, -7000, 7849) == 0);
+		INPUT_TEST_CHECK(normalise_gamepad_axis(gamepad_axis_ltrigger, 30, 30) == 0);
+		for(int bit = 0; bit < 16; ++bit)
+			INPUT_TEST_CHECK(get_gamepad_key(bit) != key_invalid || bit == 10 || bit == 11);
+		return true;
+	}
+	
+	bool test_axis_normaliser()
+	{
+		// a sweep of states covering the deadzone edges, the extremes and an odd batch size
+		std::vector<gamepad_state> states;
+		for(int v = -32768; v <= 32767; v += 1021)
+		{
+			gamepad_state s = make_gamepad_state();
+			s.axes[gamepad_axis_lthumb_x] = (tycho::core::int16)v;
+			s.axes[gamepad_axis_lthumb_y] = (tycho::core::int16)(-v - 1);
+			s.axes[gamepad_axis_rthumb_x] = (tycho::core::int16)(v / 3);
+			s.axes[gamepad_axis_rthumb_y] = (tycho::core::int16)v;
+			s.axes[gamepad_axis_ltrigger] = (tycho::core::int16)((v + 32768) & 255);
+			s.axes[gamepad_axis_rtrigger] = (tycho::core::int16)(255 - ((v + 32768) & 255));
+			states.push_back(s);
+		}
+		gamepad_state edge = make_gamepad_state();
+		edge.axes[gamepad_axis_lthumb_x] = 7849;
+		edge.axes[gamepad_axis_lthumb_y] = -7850;
+		edge.axes[gamepad_axis_ltrigger] = 30;
+		edge.axes[gamepad_axis_rtrigger] = 31;
+		states.push_back(edge);
+		const int n = (int)states.size();
+		
+		std::vector<float> vec(n * gamepad_axis_count), ref(n * gamepad_axis_count);
+		gamepad_config config = gamepad_config::make_default();
+		const deadzone_mode modes[] = { deadzone_axial, deadzone_radial, deadzone_scaled_radial };
+		for(int m = 0; m < 3; ++m)
+		{
+			config.mode = modes[m];
+			normalise_gamepad_axes(&states[0], n, config, &vec[0]);
+			normalise_gamepad_axes_scalar(&states[0], n, config, &ref[0]);
+			INPUT_TEST_CHECK(memcmp(&vec[0], &ref[0], vec.size() * sizeof(float)) == 0);
+			for(size_t i = 0; i < vec.size(); ++i)
+				INPUT_TEST_CHECK(vec[i] >= -1.0f && vec[i] <= 1.0f);
+		}
+		
+		// axial matches the per axis normaliser exactly
+		config.mode = deadzone_axial;
+		normalise_gamepad_axes(&states[0], n, config, &vec[0]);
+		for(int i = 0; i < n; ++i)
+		{
+			for(int a = 0; a < gamepad_axis_count; ++a)
+			{
+				float expected = normalise_gamepad_axis((gamepad_axis)a, states[i].axes[a], config.deadzones[a]);
+				INPUT_TEST_CHECK(memcmp(&vec[i * gamepad_axis_count + a], &expected, sizeof(float)) == 0);
+			}
+		}
+		
+		// radial keeps the small component of a push outside the circle that axial snaps to zero
+		gamepad_state diag = make_gamepad_state();
+		diag.axes[gamepad_axis_lthumb_x] = 2000;
+		diag.axes[gamepad_axis_lthumb_y] = 20000;
+		float out[gamepad_axis_count];
+		normalise_gamepad_axes(&diag, 1, config, out);
+		INPUT_TEST_CHECK(out[gamepad_axis_lthumb_x] == 0);
+		config.mode = deadzone_radial;
+		normalise_gamepad_axes(&diag, 1, config, out);
+		INPUT_TEST_CHECK(out[gamepad_axis_lthumb_x] == 2000 / 32768.0f);
+		diag.axes[gamepad_axis_lthumb_x] = 5000;
+		diag.axes[gamepad_axis_lthumb_y] = 5000;
+		normalise_gamepad_axes(&diag, 1, config, out);
+		INPUT_TEST_CHECK(out[gamepad_axis_lthumb_x] == 0 && out[gamepad_axis_lthumb_y] == 0);
+		diag.axes[gamepad_axis_lthumb_x] = 32767;
+		diag.axes[gamepad_axis_lthumb_y] = 32767;
+		config.mode = deadzone_scaled_radial;
+		normalise_gamepad_axes(&diag, 1, config, out);
+		INPUT_TEST_CHECK(fabsf(out[gamepad_axis_lthumb_x] - 0.70710677f) < 1e-4f);
+		
+		// a y only change re-emits both components of the stick in radial modes
+		gamepad_state prev = make_gamepad_state();
+		gamepad_state cur = prev;
+		cur.axes[gamepad_axis_lthumb_y] = 20000;
+		packet_collector collector;
+		emit_gamepad_events(1, prev, cur, config, &collector);
+		INPUT_TEST_CHECK(collector.m_packets.size() == 2);
+		return true;
+	}
+	
+#if defined(__linux__)
+	void write_evdev_event(int fd, int type, int code, int value)
+	{
+		struct input_event ev;
+		memset(&ev, 0, sizeof(ev));
+		ev.type = type;
+		ev.code = code;
+		ev.value = value;
+		ssize_t written = write(fd, &ev, sizeof(ev));
+		(void)written;
+	}
+	
+	bool test_evdev_driver()
+	{
+		int fds[2];
+		INPUT_TEST_CHECK(pipe(fds) == 0);
+		lnx::evdev_driver driver;
+		INPUT_TEST_CHECK(driver.add_device(fds[0], device_gamepad, "Pipe Pad"));
+		INPUT_TEST_CHECK(driver.initialise(3));
+		INPUT_TEST_CHECK(driver.get_num_devices() == 1);
+		int id = driver.get_device_desc(0)->id;
+		INPUT_TEST_CHECK(id == make_device_id(3, 0));
+		INPUT_TEST_CHECK(strcmp(driver.get_device_desc(0)->name, "Pipe Pad") == 0);
+		
+		packet_collector collector;
+		driver.update(&collector);
+		INPUT_TEST_CHECK(collector.m_packets.empty());
+		
+		write_evdev_event(fds[1], EV_KEY, BTN_SOUTH, 1);
+		write_evdev_event(fds[1], EV_KEY, BTN_SOUTH, 2);	// auto repeat is ignored
+		write_evdev_event(fds[1], EV_REL, REL_X, 3);
+		write_evdev_event(fds[1], EV_REL, REL_Y, -2);
+		write_evdev_event(fds[1], EV_REL, REL_X, 1);
+		write_evdev_event(fds[1], EV_SYN, SYN_REPORT, 0);
+		write_evdev_event(fds[1], EV_ABS, ABS_X, 32767);
+		write_evdev_event(fds[1], EV_ABS, ABS_RZ, 255);
+		write_evdev_event(fds[1], EV_ABS, ABS_HAT0Y, -1);
+		write_evdev_event(fds[1], EV_SYN, SYN_DROPPED, 0);
+		write_evdev_event(fds[1], EV_KEY, KEY_Q, 1);		// dropped
+		write_evdev_event(fds[1], EV_SYN, SYN_REPORT, 0);
+		write_evdev_event(fds[1], EV_KEY, KEY_Q, 0);
+		driver.update(&collector);
+		
+		const std::vector<event_packet>& p = collector.m_packets;
+		INPUT_TEST_CHECK(p.size() == 6);
+		INPUT_TEST_CHECK(p[0].index == id && p[0].ptype == packet_type_keyboard);
+		INPUT_TEST_CHECK(p[0].keyboard.key == key_button_a && p[0].keyboard.state == key_state_down);
+		INPUT_TEST_CHECK(p[1].ptype == packet_type_mouse && p[1].mouse.dx == 4 && p[1].mouse.dy == -2);
+		INPUT_TEST_CHECK(p[2].ptype == packet_type_axis && p[2].axis.axis == axis_lthumb_x && p[2].axis.value == 1.0f);
+		INPUT_TEST_CHECK(p[3].ptype == packet_type_axis && p[3].axis.axis == axis_rtrigger_x && p[3].axis.value == 1.0f);
+		INPUT_TEST_CHECK(p[4].ptype == packet_type_keyboard && p[4].keyboard.key == key_button_dpad_up);
+		INPUT_TEST_CHECK(p[5].keyboard.key == key_q && p[5].keyboard.state == key_state_up);
+		
+		// an 8 bit stick is centred on the middle of its range rather than treated as a trigger
+		INPUT_TEST_CHECK(driver.set_axis_range(0, axis_lthumb_x, 0, 255));
+		INPUT_TEST_CHECK(driver.set_axis_range(0, axis_rthumb_y, 0, 255, 4));
+		write_evdev_event(fds[1], EV_ABS, ABS_X, 0);
+		write_evdev_event(fds[1], EV_ABS, ABS_X, 255);
+		write_evdev_event(fds[1], EV_ABS, ABS_X, 64);
+		write_evdev_event(fds[1], EV_ABS, ABS_RY, 129);		// inside the flat region
+		write_evdev_event(fds[1], EV_ABS, ABS_RY, 0);
+		driver.update(&collector);
+		INPUT_TEST_CHECK(p.size() == 11);
+		INPUT_TEST_CHECK(p[6].axis.axis == axis_lthumb_x && p[6].axis.value == -1.0f);
+		INPUT_TEST_CHECK(p[7].axis.value == 1.0f);
+		INPUT_TEST_CHECK(p[8].axis.value > -0.51f && p[8].axis.value < -0.49f);
+		INPUT_TEST_CHECK(p[9].axis.axis == axis_rthumb_y && p[9].axis.value == 0.0f);
+		INPUT_TEST_CHECK(p[10].axis.value == 1.0f);	// y points up
+		
+		close(fds[1]);
+		driver.update(&collector);
+		INPUT_TEST_CHECK(p.size() == 11);
+		return true;
+	}
+	
+	bool test_shm_driver()
+	{
+		char name[64];
+		snprintf(name, sizeof(name), "/tyinput_test_%d", (int)getpid());
+		static const lnx::shm_driver::device_config devices[] = {
+			{ device_gamepad, "Bot Pad" },
+			{ device_mouse, "Bot Mouse" }
+		};
+		lnx::shm_driver driver(name, devices, 2, 8);
+		INPUT_TEST_CHECK(tyi_shm_attach(name) == 0);
+		INPUT_TEST_CHECK(driver.initialise(2));
+		INPUT_TEST_CHECK(driver.get_num_devices() == 2);
+		INPUT_TEST_CHECK(driver.get_device_desc(1)->id == make_device_id(2, 1));
+		INPUT_TEST_CHECK(strcmp(driver.get_device_desc(0)->name, "Bot Pad") == 0);
+		
+		tyi_shm_header* shm = tyi_shm_attach(name);
+		INPUT_TEST_CHECK(shm && shm->num_devices == 2);
+		INPUT_TEST_CHECK(tyi_shm_find_device(shm, "Bot Mouse") == 1);
+		INPUT_TEST_CHECK(tyi_shm_key(shm, 0, key_button_a, key_state_down));
+		INPUT_TEST_CHECK(tyi_shm_axis(shm, 0, axis_rthumb_y, -0.5f));
+		INPUT_TEST_CHECK(tyi_shm_mouse(shm, 1, 7, -3));
+		INPUT_TEST_CHECK(tyi_shm_key(shm, 5, key_button_a, key_state_down));	// no such device
+		
+		packet_collector collector;
+		driver.update(&collector);
+		const std::vector<event_packet>& p = collector.m_packets;
+		INPUT_TEST_CHECK(p.size() == 3 && driver.get_num_invalid() == 1);
+		INPUT_TEST_CHECK(p[0].index == make_device_id(2, 0) && p[0].keyboard.key == key_button_a && p[0].keyboard.state == key_state_down);
+		INPUT_TEST_CHECK(p[1].ptype == packet_type_axis && p[1].axis.axis == axis_rthumb_y && p[1].axis.value == -0.5f);
+		INPUT_TEST_CHECK(p[2].index == make_device_id(2, 1) && p[2].mouse.dx == 7 && p[2].mouse.dy == -3);
+		
+		// a full ring drops new events until it is drained
+		for(int i = 0; i < 8; ++i)
+			INPUT_TEST_CHECK(tyi_shm_mouse(shm, 1, i, 0));
+		INPUT_TEST_CHECK(!tyi_shm_mouse(shm, 1, 8, 0));
+		INPUT_TEST_CHECK(driver.get_num_dropped() == 1);
+		collector.m_packets.clear();
+		driver.update(&collector);
+		INPUT_TEST_CHECK(p.size() == 8 && p[7].mouse.dx == 7);
+		
+		// writers on several threads keep their own order
+		const int NumWriters = 4;
+		const int EventsPerWriter = 2000;
+		std::vector<std::thread> writers;
+		for(int w = 0; w < NumWriters; ++w)
+		{
+			writers.push_back(std::thread([shm, w]() {
+				for(int i = 0; i < EventsPerWriter; )
+					i += tyi_shm_mouse(shm, 1, w, i);
+			}));
+		}
+		collector.m_packets.clear();
+		int next[NumWriters] = { 0 };
+		bool ordered = true;
+		while((int)p.size() < NumWriters * EventsPerWriter)
+		{
+			size_t first = p.size();
+			driver.update(&collector);
+			for(size_t i = first; i < p.size(); ++i)
+				ordered &= p[i].mouse.dy == next[p[i].mouse.dx]++;
+		}
+		for(int w = 0; w < NumWriters; ++w)
+			writers[w].join();
+		INPUT_TEST_CHECK(ordered);
+		
+		tyi_shm_detach(shm);
+		return true;
+	}
+#endif
+
+} // end anonymous namespace
 
 int main(int , char* [])
 {
-	return 0;
-}
\ No newline at end of file
+	int failures = 0;
+	failures += !test_device_router();
+	failures += !test_event_ring();
+	failures += !test_packed_input();
+	failures += !test_scoped_index();
+	failures += !test_name_table();
+	failures += !test_capture_thread();
+	failures += !test_interface_dispatch();
+	failures += !test_binding_layers();
+	failures += !test_latency_stats();
+	failures += !test_combos();
+	failures += !test_coalescing();
+	failures += !test_batched_dispatch();
+	failures += !test_hotplug();
+	failures += !test_timestamp_merge();
+	failures += !test_zero_allocations();
+	failures += !test_parallel_dispatch();
+	failures += !test_record_replay();
+	failures += !test_input_stream();
+	failures += !test_polled_state();
+	failures += !test_many_groups();
+	failures += !test_input_history();
+	failures += !test_gamepad_diff();
+	failures += !test_axis_normaliser();
+#if defined(__linux__)
+	failures += !test_evdev_driver();
+	failures += !test_shm_driver();
+#endif
+	return failures;
+}
@@ -0,0 +1,36 @@
+//////////////////////////////////////////////////////////////////////////////
+// Tycho Game Library
+// Copyright (C) 2026 Martin Slater
+// Created : Saturday, 17 October 2026 11:26:05 AM
+//////////////////////////////////////////////////////////////////////////////
+#if _MSC_VER > 1000
+#pragma once
+#endif  // _MSC_VER
+
+#ifndef __TIMESTAMP_H_A84C1E6B_2F37_4D95_8E0A_C57B93D1F246_
+#define __TIMESTAMP_H_A84C1E6B_2F37_4D95_8E0A_C57B93D1F246_
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "input/input_abi.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// CLASS
+//////////////////////////////////////////////////////////////////////////////
+
+namespace tycho
+{
+namespace input
+{
+
+	/// \returns the current time in nanoseconds from a monotonic clock. This is the 
+	/// time base of event_packet::timestamp and is shared by every driver so packets
+	/// from different drivers can be ordered by it. It has an arbitrary epoch so only
+	/// differences between timestamps are meaningful.
+	TYCHO_INPUT_ABI core::int64 get_timestamp();
+
+} // end namespace
+} // end namespace
+
+#endif // __TIMESTAMP_H_A84C1E6B_2F37_4D95_8E0A_C57B93D1F246_
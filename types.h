@@ -36,6 +36,7 @@ namespace input
 		device_xenoncontroller,
 		device_gccontroller,
 		device_wiimote,
+		device_gamepad,			///< generic gamepad
 		device_count
 	};
 	
@@ -137,7 +138,15 @@ namespace input
 		key_button_dpad_up,
 		key_button_dpad_down,
 		key_button_dpad_left,
-		key_button_dpad_right		
+		key_button_dpad_right,
+		
+		// keyboard modifiers, either side of the keyboard. After the gamepad buttons
+		// so the values of the keys above don't change.
+		key_shift,
+		key_control,
+		
+		/// number of key types, must be last
+		key_count
 	};
 	
 	/// input axis
@@ -149,7 +158,10 @@ namespace input
 		axis_rthumb_x,
 		axis_rthumb_y,
 		axis_rtrigger_x,
-		axis_ltrigger_x,				
+		axis_ltrigger_x,
+		
+		/// number of axis types, must be last
+		axis_count
 	};
 
 	/// key states
@@ -157,12 +169,32 @@ namespace input
 	{
 		key_state_invalid = 0,
 		key_state_up,
-		key_state_down
+		key_state_down,
+		
+		/// number of key states, must be last
+		key_state_count
+	};
+			
+	/// how continuous input for a single action is combined within an update. Key 
+	/// edges are never combined so press and release ordering is preserved.
+	enum coalesce_policy
+	{
+		/// chosen from the action's requirements, mouse actions sum and axis actions keep the last value
+		coalesce_default = 0,
+		
+		/// dispatch every event as it arrives
+		coalesce_none,
+		
+		/// dispatch once at the end of the update with the deltas summed
+		coalesce_sum,
+		
+		/// dispatch once at the end of the update with the last value
+		coalesce_latest
 	};
 			
 	/// published action, this can be associated with a key combination to trigger it.
 	/// this combination must contain one source meeting the requirements but can have other
-	/// modifiers required to trigger it
+	/// modifiers required to trigger it, see combo.
 	struct action
 	{
 		const char* name;
@@ -171,8 +203,8 @@ namespace input
 	};
 		
 	
-	/// an input into a key binding
-	struct input
+	/// field wise view of an input, the layout input used before it was packed.
+	struct input_fields
 	{
 		event_type event;
 		key_type   key;
@@ -180,36 +212,65 @@ namespace input
 		axis_type  axis;				
 	};
 	
+	/// an input into a key binding. The fields are packed into a single word,
+	/// a byte each of event, key, state and axis from the least significant end,
+	/// so comparing and hashing inputs are single word operations.
+	struct input
+	{
+		core::uint32 bits;
+		
+		/// \name field accessors
+		//@{
+		constexpr event_type event() const { return (event_type)(bits & 0xff); }
+		constexpr key_type key() const { return (key_type)((bits >> 8) & 0xff); }
+		constexpr key_state state() const { return (key_state)((bits >> 16) & 0xff); }
+		constexpr axis_type axis() const { return (axis_type)(bits >> 24); }
+		//@}
+		
+		/// \returns the field wise view of the input
+		input_fields fields() const
+			{ input_fields f = { event(), key(), state(), axis() }; return f; }
+	};
+	
+	static_assert(key_count <= 0xff && axis_count <= 0xff, "input fields must fit in a byte");
+	
+	/// helper to pack input fields
+	constexpr input make_input(event_type e, key_type k, key_state s, axis_type a)
+	{
+		return input{ (core::uint32)e | ((core::uint32)k << 8) | ((core::uint32)s << 16) | ((core::uint32)a << 24) };
+	}
+	
+	/// helper to pack a field wise input
+	inline input make_input(const input_fields& f)
+		{ return make_input(f.event, f.key, f.state, f.axis); }
+	
 	/// input equality function
-	/// \warning all unused input fields must be initialised to zero
-	inline bool operator==(const input& lhs, const input& rhs)
+	constexpr bool operator==(const input& lhs, const input& rhs)
 	{
-		return (lhs.event == rhs.event &&
-		        lhs.key == rhs.key &&
-		        lhs.state == rhs.state &&
-		        lhs.axis == rhs.axis);
+		return lhs.bits == rhs.bits;
 	}
 	
 	/// input hashing function
 	inline core::uint32 hash(const input& i)
 	{
-		return core::hash_raw_bytes(i);
+		// fibonacci hashing to spread the packed fields across the word
+		return i.bits * 2654435769u;
 	}
 	
 	/// helper to define an axis input 
-	inline input make_axis_input(axis_type t)
-		{ input i; core::mem_zero(i); i.event = event_type_axis; i.axis = t; return i; }
+	constexpr input make_axis_input(axis_type t)
+		{ return make_input(event_type_axis, key_invalid, key_state_invalid, t); }
 
 	/// helper to define a mouse input
-	inline input make_mouse_input()
-		{ input i; core::mem_zero(i); i.event = event_type_mouse; return i; }
+	constexpr input make_mouse_input()
+		{ return make_input(event_type_mouse, key_invalid, key_state_invalid, axis_type_invalid); }
 	
 	///  helper to define key input (or button)
-	inline input make_keyboard_input(key_type k, key_state s)	
-		{ input i; core::mem_zero(i); i.event = event_type_key; i.key = k; i.state = s; return i; }
+	constexpr input make_keyboard_input(key_type k, key_state s)	
+		{ return make_input(event_type_key, k, s, axis_type_invalid); }
 		
-	inline input make_empty_input()
-		{ input i; core::mem_zero(i); i.event = event_type_none; return i; }
+	constexpr input make_empty_input()
+		{ return make_input(event_type_none, key_invalid, key_state_invalid, axis_type_invalid); }
 
 	/// key binding
 	struct binding
@@ -217,6 +278,33 @@ namespace input
 		const char* action;
 		input		trigger;
 	};
+	
+	/// how the keys of a combo have to be pressed
+	enum combo_type
+	{
+		/// trigger pressed while all modifiers are held, e.g. shift+e or lb+a
+		combo_chord,
+		
+		/// trigger pressed twice within time_ms while all modifiers are held
+		combo_double_tap,
+		
+		/// trigger held for time_ms while all modifiers are held
+		combo_hold
+	};
+	
+	/// binding of an action to a combination of keys. Combos are dispatched as a key 
+	/// down on their action with the trigger as the key. A chord takes the trigger's
+	/// key down from its plain binding, double taps and holds fire as well as it.
+	struct combo
+	{
+		static const int MaxModifiers = 3;
+		
+		const char* action;
+		combo_type	type;
+		key_type	trigger;					///< key completing the combo
+		key_type	modifiers[MaxModifiers];	///< keys that must be held, unused entries are key_invalid
+		int			time_ms;					///< double tap window or hold time, unused by chords
+	};
 						
 	/// mouse packet
 	struct mouse_packet
@@ -229,7 +317,13 @@ namespace input
 	{
 		packet_type_keyboard,
 		packet_type_mouse,
-		packet_type_axis
+		packet_type_axis,
+		
+		/// a device was connected, index is its id
+		packet_type_device_added,
+		
+		/// a device was disconnected, index is its id
+		packet_type_device_removed
 	};
 		
 	/// keyboard packet
@@ -246,6 +340,14 @@ namespace input
 		float	  value;
 	};
 	
+	/// device arrival or removal packet, the rest of the description is 
+	/// available from the owning driver.
+	struct device_packet
+	{
+		device_type type;
+		int			index;	///< index of the device within its type
+	};
+	
 	/// helper function to make an axis packet
 	inline axis_packet make_axis_packet(axis_type t, float v)
 		{ axis_packet p; p.axis = t; p.value = v; return p;	}
@@ -257,18 +359,37 @@ namespace input
 	/// helper function to make an keyboard packet
 	inline keyboard_packet make_keyboard_packet(key_type type, key_state state)
 		{ keyboard_packet p; p.state = state; p.key = type; return p;	}
+
+	/// helper function to make a device packet
+	inline device_packet make_device_packet(const device_description& desc)
+		{ device_packet p; p.type = desc.type; p.index = desc.index; return p; }
 	
 	/// input event packet
 	struct event_packet
 	{	
-		int			timestamp;
-		int			index;
-		packet_type ptype;
+		core::int64	timestamp;	///< time the event was captured in nanoseconds, see get_timestamp
+		int			index;		///< id of the device that generated the event
+		packet_type ptype;		///< selects the active payload below
 		union
 		{
 			mouse_packet	mouse;
 			keyboard_packet keyboard;
 			axis_packet		axis;
+			device_packet	device;
+		};
+	};
+
+	/// triggered action as delivered to a batched input handler
+	struct action_record
+	{
+		core::int64	timestamp;	///< capture time of the event, the earliest one for coalesced actions
+		int			action_id;	///< id of the triggered action
+		packet_type kind;		///< selects the active payload below
+		union
+		{
+			mouse_packet	mouse;
+			keyboard_packet keyboard;
+			float			value;		///< axis value
 		};
 	};
 
@@ -280,6 +401,28 @@ namespace input
 		virtual bool handle_axis(int /*action_id*/, const float /*value*/) { return false; }
 		virtual bool handle_button(int /*action_id*/) { return false; }
 		virtual bool handle_key(int /*action_id*/, key_type /*key*/, key_state /*state*/) { return false; }
+		
+		/// \returns true to receive actions through handle_batch once per update instead
+		/// of through the per event methods. Checked when an action group is pushed.
+		virtual bool wants_batches() const { return false; }
+		
+		/// called once per update with every action triggered for this handler across all
+		/// groups, in the order they were dispatched. The default forwards each record to
+		/// the per event methods.
+		virtual void handle_batch(const action_record* records, int count)
+		{
+			for(int i = 0; i < count; ++i)
+			{
+				const action_record& r = records[i];
+				switch(r.kind)
+				{
+					case packet_type_keyboard: handle_key(r.action_id, r.keyboard.key, r.keyboard.state); break;
+					case packet_type_mouse: handle_mouse(r.action_id, r.mouse.dx, r.mouse.dy); break;
+					case packet_type_axis: handle_axis(r.action_id, r.value); break;
+					default: break;
+				}
+			}
+		}
 	};	
 
 	/** \page ihpage Input handlers